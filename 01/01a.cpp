@@ -39,15 +39,24 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+
+#include "input.h"
+#include "puzzle.h"
 
 using namespace std;
 
+namespace puzzle01a {
+
+AOC_PUZZLE_STREAMS
+
 
-int main() {
-    string line;
+int solve(int argc, char* argv[]) {
+    aoc::Input input;
+    string_view line;
     int sum = 0;
 
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
 
         int digit1 = -1;
         int digit2 = -1;
@@ -66,3 +75,8 @@ int main() {
     cout << sum << '\n';
     return 0;
 }
+
+}  // namespace puzzle01a
+
+
+AOC_PUZZLE_MAIN(01a)
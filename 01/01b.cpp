@@ -58,9 +58,17 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+
+#include "input.h"
+#include "puzzle.h"
 
 using namespace std;
 
+namespace puzzle01b {
+
+AOC_PUZZLE_STREAMS
+
 struct Values {
     string name;
     int    value;
@@ -87,12 +95,13 @@ Values values[] {
     { "nine", 9 },
 };
 
-int main(int argc, char* argv[]) {
-    string line;
+int solve(int argc, char* argv[]) {
+    aoc::Input input;
+    string_view line;
     int sum = 0;  // Total of all line values (10 * firstDigit + lastDigit).
 
     // Loop through each line of input.
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
 
         int firstDigit = -1;
         int lastDigit  = -1;
@@ -124,3 +133,8 @@ int main(int argc, char* argv[]) {
     cout << sum << '\n';
     return 0;
 }
+
+}  // namespace puzzle01b
+
+
+AOC_PUZZLE_MAIN(01b)
@@ -50,55 +50,61 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <cstdint>
 #include <iostream>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include "input.h"
+#include "puzzle.h"
+#include "tokenizer.h"
 
 using namespace std;
 using std::cout;
 
-enum class TerminatorType { None, CommaOrSemicolon };
+namespace puzzle02a {
+
+AOC_PUZZLE_STREAMS
+
 enum Color { Red = 0, Green = 1, Blue = 2};
 
 const int maximums[] { 12, 13, 14 };
 
-int main() {
+int solve(int argc, char* argv[]) {
 
-    string line;
+    aoc::Input input;
+    string_view line;
     int sum = 0;
     int totalSum = 0;
 
-    while (getline(cin, line)) {
-        istringstream is(line);
+    vector<int64_t>  values;   // Game ID, followed by each color count
+    vector<uint32_t> ends;     // Offset just past each value
 
-        string dummy;
-        int    gameId;     // Game Identifier
-        int    count;      // Color Count
-        string colorName;  // Color Name
+    while (input.getline(line)) {
+        values.resize(aoc::maxIntegers(line));
+        ends.resize(values.size());
 
-        is >> dummy >> gameId >> dummy;   // Skip "Game", grab gameId, skip colon.
+        size_t count;
+        if (!aoc::extractIntegers(line, values, count, ends) || count == 0)
+            continue;
+
+        int gameId = values[0];   // Game Identifier
 
         totalSum += gameId;
 
-        TerminatorType termType;
         bool possible = true;
 
-        do {
-            is >> count >> colorName;
-
-            auto lastChar = colorName.back();
+        for (size_t i = 1;  possible && i < count;  ++i) {
+            // Each color count is followed by a space and the color name; the initial letter is enough.
+            const char colorInitial = (ends[i] + 1 < line.size()) ? line[ends[i] + 1] : 'b';
 
-            termType = (lastChar == ',' || lastChar == ';') ? TerminatorType::CommaOrSemicolon : TerminatorType::None;
-            if (termType != TerminatorType::None)
-                colorName.pop_back();
-
-            Color color = (colorName == "red")   ? Color::Red
-                        : (colorName == "green") ? Color::Green
+            Color color = (colorInitial == 'r') ? Color::Red
+                        : (colorInitial == 'g') ? Color::Green
                         : Color::Blue;
 
-            possible = count <= maximums[static_cast<int>(color)];
-
-        } while (possible && termType != TerminatorType::None);
+            possible = values[i] <= maximums[static_cast<int>(color)];
+        }
 
         if (possible)
             sum += gameId;
@@ -107,3 +113,8 @@ int main() {
     cout << sum << " / " << totalSum << '\n';
     return 0;
 }
+
+}  // namespace puzzle02a
+
+
+AOC_PUZZLE_MAIN(02a)
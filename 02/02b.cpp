@@ -81,55 +81,59 @@
 // power of these sets?
 //--------------------------------------------------------------------------------------------------
 
+#include <cstdint>
 #include <iostream>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include "input.h"
+#include "puzzle.h"
+#include "tokenizer.h"
 
 using namespace std;
 using std::cout;
 
-enum class TerminatorType { None, CommaOrSemicolon };
+namespace puzzle02b {
+
+AOC_PUZZLE_STREAMS
+
 enum Color { Red = 0, Green = 1, Blue = 2};
 
-int main() {
+int solve(int argc, char* argv[]) {
 
-    string line;
+    aoc::Input input;
+    string_view line;
     int sum = 0;
     int minimums[3];
 
-    while (getline(cin, line)) {
-        istringstream is(line);
-
-        minimums[0] = minimums[1] = minimums[2] = 0;
-
-        string dummy;
-        int    gameId;      // Game Identifier
-        int    colorCount;  // Color Count
-        string colorName;   // Color Name
+    vector<int64_t>  values;   // Game ID, followed by each color count
+    vector<uint32_t> ends;     // Offset just past each value
 
-        is >> dummy >> gameId >> dummy;   // Skip "Game", grab gameId, skip colon.
+    while (input.getline(line)) {
+        values.resize(aoc::maxIntegers(line));
+        ends.resize(values.size());
 
-        TerminatorType termType;
+        size_t count;
+        if (!aoc::extractIntegers(line, values, count, ends) || count == 0)
+            continue;
 
-        do {
-            is >> colorCount >> colorName;
-
-            auto lastChar = colorName.back();
+        minimums[0] = minimums[1] = minimums[2] = 0;
 
-            termType = (lastChar == ',' || lastChar == ';') ? TerminatorType::CommaOrSemicolon : TerminatorType::None;
-            if (termType != TerminatorType::None)
-                colorName.pop_back();
+        for (size_t i = 1;  i < count;  ++i) {
+            // Each color count is followed by a space and the color name; the initial letter is enough.
+            const char colorInitial = (ends[i] + 1 < line.size()) ? line[ends[i] + 1] : 'b';
+            const int  colorCount   = values[i];
 
-            int colorIndex = (colorName == "red")   ? 0
-                           : (colorName == "green") ? 1
+            int colorIndex = (colorInitial == 'r') ? 0
+                           : (colorInitial == 'g') ? 1
                            : 2;
 
             int& minimum = minimums[colorIndex];
 
             if (colorCount > minimum)
                 minimum = colorCount;
-
-        } while (termType != TerminatorType::None);
+        }
 
         sum += minimums[0] * minimums[1] * minimums[2];
     }
@@ -137,3 +141,8 @@ int main() {
     cout << sum << '\n';
     return 0;
 }
+
+}  // namespace puzzle02b
+
+
+AOC_PUZZLE_MAIN(02b)
@@ -46,14 +46,23 @@
 //----------------------------------------------------------------------------------------------------------------------
 
 #include <cctype>
+#include <charconv>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+
 using namespace std;
 
+namespace puzzle03a {
+
+AOC_PUZZLE_STREAMS
+
 
-int numberLength(const string& line, int column, int width) {
+int numberLength(string_view line, int column, int width) {
     int length = 0;
     while (column + length < width && isdigit(line[column + length]))
         ++length;
@@ -66,7 +75,7 @@ bool isSymbol(char c) {
 }
 
 
-bool symbolAdjacentLeft(const vector<string>& lines, int lineIndex, int begin, int lineCount, int width) {
+bool symbolAdjacentLeft(const vector<string_view>& lines, int lineIndex, int begin, int lineCount, int width) {
     if (begin == 0)
         return false;
 
@@ -82,7 +91,7 @@ bool symbolAdjacentLeft(const vector<string>& lines, int lineIndex, int begin, i
 }
 
 
-bool symbolAdjacentRight(const vector<string>& lines, int lineIndex, int end, int lineCount, int width) {
+bool symbolAdjacentRight(const vector<string_view>& lines, int lineIndex, int end, int lineCount, int width) {
     int column = end + 1;
 
     if (column >= width)
@@ -98,7 +107,7 @@ bool symbolAdjacentRight(const vector<string>& lines, int lineIndex, int end, in
 }
 
 
-bool symbolAdjacentTop(const vector<string>& lines, int lineIndex, int begin, int end, int lineCount, int width) {
+bool symbolAdjacentTop(const vector<string_view>& lines, int lineIndex, int begin, int end, int lineCount, int width) {
     --lineIndex;
     if (lineIndex < 0)
         return false;
@@ -115,7 +124,7 @@ bool symbolAdjacentTop(const vector<string>& lines, int lineIndex, int begin, in
 }
 
 
-bool symbolAdjacentBottom(const vector<string>& lines, int lineIndex, int begin, int end, int lineCount, int width) {
+bool symbolAdjacentBottom(const vector<string_view>& lines, int lineIndex, int begin, int end, int lineCount, int width) {
     ++lineIndex;
     if (lineIndex >= lineCount)
         return false;
@@ -132,14 +141,15 @@ bool symbolAdjacentBottom(const vector<string>& lines, int lineIndex, int begin,
 }
 
 
-int main() {
-    vector<string> lines;
-    string line;
+int solve(int argc, char* argv[]) {
+    aoc::Input input;
+    vector<string_view> lines;
+    string_view line;
     int lineNumber = 0;
     int sum = 0;
 
     int width = -1;
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
         ++lineNumber;
         if (width == -1) {
             width = line.length();
@@ -159,7 +169,8 @@ int main() {
                 ++column;
             if (column >= width)
                 break;
-            int partNumber = atoi(lines[lineIndex].c_str() + column);
+            int partNumber = 0;
+            from_chars(lines[lineIndex].data() + column, lines[lineIndex].data() + width, partNumber);
 
             int partNumberLength = numberLength(lines[lineIndex], column, width);
             int partNumberEnd = column + partNumberLength - 1;
@@ -181,3 +192,8 @@ int main() {
     cout << '\n' << sum << '\n';
     return 0;
 }
+
+}  // namespace puzzle03a
+
+
+AOC_PUZZLE_MAIN(03a)
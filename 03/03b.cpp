@@ -85,21 +85,32 @@
 //----------------------------------------------------------------------------------------------------------------------
 
 #include <cctype>
+#include <charconv>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+
 using namespace std;
 
+namespace puzzle03b {
+
+AOC_PUZZLE_STREAMS
 
-int getNumberAt(const char *s, int offset) {
-    while (offset > 0 && isdigit(s[offset-1]))
+
+int getNumberAt(string_view line, int offset) {
+    while (offset > 0 && isdigit(line[offset-1]))
         --offset;
-    return atoi(s + offset);
+    int number = 0;
+    from_chars(line.data() + offset, line.data() + line.size(), number);
+    return number;
 }
 
 
-int getGearRatio(const vector<string>& lines, int width, int lineIndex, int columnIndex) {
+int getGearRatio(const vector<string_view>& lines, int width, int lineIndex, int columnIndex) {
     int countAdjacent = 0;
     int gearRatio = 1;
 
@@ -110,17 +121,17 @@ int getGearRatio(const vector<string>& lines, int width, int lineIndex, int colu
     bool roomRight = columnIndex < (width - 1);
 
     if (roomTop) {
-        const string& lineAbove = lines[lineIndex-1];
+        string_view lineAbove = lines[lineIndex-1];
         if (isdigit(lineAbove[columnIndex])) {
-            gearRatio *= getNumberAt(lineAbove.c_str(), columnIndex);
+            gearRatio *= getNumberAt(lineAbove, columnIndex);
             ++countAdjacent;
         } else {
             if (roomLeft && isdigit(lineAbove[columnIndex-1])) {
-                gearRatio *= getNumberAt(lineAbove.c_str(), columnIndex-1);
+                gearRatio *= getNumberAt(lineAbove, columnIndex-1);
                 ++countAdjacent;
             }
             if (roomRight && isdigit(lineAbove[columnIndex+1])) {
-                gearRatio *= getNumberAt(lineAbove.c_str(), columnIndex+1);
+                gearRatio *= getNumberAt(lineAbove, columnIndex+1);
                 ++countAdjacent;
             }
         }
@@ -130,12 +141,12 @@ int getGearRatio(const vector<string>& lines, int width, int lineIndex, int colu
         return -1;
 
     if (roomLeft && isdigit(lines[lineIndex][columnIndex-1])) {
-        gearRatio *= getNumberAt(lines[lineIndex].c_str(), columnIndex-1);
+        gearRatio *= getNumberAt(lines[lineIndex], columnIndex-1);
         ++countAdjacent;
     }
 
     if (roomRight && isdigit(lines[lineIndex][columnIndex+1])) {
-        gearRatio *= getNumberAt(lines[lineIndex].c_str(), columnIndex+1);
+        gearRatio *= getNumberAt(lines[lineIndex], columnIndex+1);
         ++countAdjacent;
     }
 
@@ -143,17 +154,17 @@ int getGearRatio(const vector<string>& lines, int width, int lineIndex, int colu
         return -1;
 
     if (roomBottom) {
-        const string& lineBelow = lines[lineIndex+1];
+        string_view lineBelow = lines[lineIndex+1];
         if (isdigit(lineBelow[columnIndex])) {
-            gearRatio *= getNumberAt(lineBelow.c_str(), columnIndex);
+            gearRatio *= getNumberAt(lineBelow, columnIndex);
             ++countAdjacent;
         } else {
             if (roomLeft && isdigit(lineBelow[columnIndex-1])) {
-                gearRatio *= getNumberAt(lineBelow.c_str(), columnIndex-1);
+                gearRatio *= getNumberAt(lineBelow, columnIndex-1);
                 ++countAdjacent;
             }
             if (roomRight && isdigit(lineBelow[columnIndex+1])) {
-                gearRatio *= getNumberAt(lineBelow.c_str(), columnIndex+1);
+                gearRatio *= getNumberAt(lineBelow, columnIndex+1);
                 ++countAdjacent;
             }
         }
@@ -163,14 +174,15 @@ int getGearRatio(const vector<string>& lines, int width, int lineIndex, int colu
 }
 
 
-int main() {
-    vector<string> lines;
-    string line;
+int solve(int argc, char* argv[]) {
+    aoc::Input input;
+    vector<string_view> lines;
+    string_view line;
     int lineNumber = 0;
     int sum = 0;
 
     int width = -1;
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
         ++lineNumber;
         if (width == -1) {
             width = line.length();
@@ -186,12 +198,6 @@ int main() {
     int lineCount = lines.size();
     for (int lineIndex = 0;  lineIndex < lineCount;  ++lineIndex) {
 
-        // Convert all extraneous symbols (neither '*' nor digit) to dots.
-        for (auto& c : lines[lineIndex]) {
-            if (c != '*' && !isdigit(c))
-                c = '.';
-        }
-
         for (int column = 0;  column < width;  ++column) {
 
             if (lines[lineIndex][column] != '*')
@@ -211,3 +217,8 @@ int main() {
     cout << '\n' << sum << '\n';
     return 0;
 }
+
+}  // namespace puzzle03b
+
+
+AOC_PUZZLE_MAIN(03b)
@@ -59,48 +59,52 @@
 //
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <cstdint>
 #include <iostream>
 #include <numeric>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+#include "tokenizer.h"
+
 using namespace std;
 
+namespace puzzle04a {
+
+AOC_PUZZLE_STREAMS
 
-int main() {
-    string line;
+
+int solve(int argc, char* argv[]) {
+    aoc::Input input;
+    string_view line;
     int sum = 0;
+    vector<int64_t> values;   // Card values
 
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
 
-        istringstream is(line);
+        // The winning numbers lie between the colon and the bar, and the selected numbers follow the bar.
 
-        string text;
-        int    cardId;     // Card Identifier
-        int    cardValue;  // Card Value
+        const size_t colon = line.find(':');
+        const size_t bar   = line.find('|');
+        if (colon == string_view::npos || bar == string_view::npos)
+            continue;
 
-        is >> text >> cardId >> text; // Skip "Card", read cardId, skip ":"
+        values.resize(aoc::maxIntegers(line));
+        size_t count;
 
         // Read in the winning numbers.
 
-        unordered_set<int> winningNumbers;
-
-        while (is >> text) {
-            if (text == "|") break;
-            cardValue = stoi(text);
-            winningNumbers.insert(cardValue);
-        }
+        aoc::extractIntegers(line.substr(colon + 1, bar - colon - 1), values, count);
+        unordered_set<int> winningNumbers(values.begin(), values.begin() + count);
 
         // Read in the selected numbers.
 
-        vector<int> selectedNumbers;
-
-        while (is >> text) {
-            cardValue = stoi(text);
-            selectedNumbers.push_back(cardValue);
-        }
+        aoc::extractIntegers(line.substr(bar + 1), values, count);
+        vector<int> selectedNumbers(values.begin(), values.begin() + count);
 
         // Define the scoring function.
 
@@ -115,3 +119,8 @@ int main() {
     cout << sum << '\n';
     return 0;
 }
+
+}  // namespace puzzle04a
+
+
+AOC_PUZZLE_MAIN(04a)
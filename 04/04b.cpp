@@ -105,15 +105,24 @@
 // the original set of scratchcards, how many total scratchcards do you end up with?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <cstdint>
 #include <iostream>
 #include <numeric>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+#include "tokenizer.h"
+
 using namespace std;
 
+namespace puzzle04b {
+
+AOC_PUZZLE_STREAMS
+
 struct Card {
     int cardId;
     unordered_set<int> winningNumbers;
@@ -123,33 +132,40 @@ struct Card {
 };
 
 
-int main() {
+int solve(int argc, char* argv[]) {
     vector<Card> cards;
 
-    string line;
-    while (getline(cin, line)) {
+    aoc::Input input;
+    string_view line;
+    vector<int64_t> values;   // Card values
+
+    while (input.getline(line)) {
+
+        // The card ID precedes the colon, the winning numbers lie between the colon and the bar, and the selected
+        // numbers follow the bar.
+
+        const size_t colon = line.find(':');
+        const size_t bar   = line.find('|');
+        if (colon == string_view::npos || bar == string_view::npos)
+            continue;
 
-        istringstream is(line);
+        values.resize(aoc::maxIntegers(line));
+        size_t count;
 
         Card card;
-        string text;
 
-        is >> text >> card.cardId >> text; // Skip "Card", read cardId, skip ":"
+        aoc::extractIntegers(line.substr(0, colon), values, count);
+        card.cardId = (count > 0) ? values[0] : 0;
 
         // Read in the winning numbers.
 
-        while (is >> text) {
-            if (text == "|") break;
-            int cardValue = stoi(text);
-            card.winningNumbers.insert(cardValue);
-        }
+        aoc::extractIntegers(line.substr(colon + 1, bar - colon - 1), values, count);
+        card.winningNumbers.insert(values.begin(), values.begin() + count);
 
         // Read in the selected numbers.
 
-        while (is >> text) {
-            int cardValue = stoi(text);
-            card.selectedNumbers.push_back(cardValue);
-        }
+        aoc::extractIntegers(line.substr(bar + 1), values, count);
+        card.selectedNumbers.assign(values.begin(), values.begin() + count);
 
         card.matchCount = 0;
         card.copies = 1;
@@ -184,3 +200,8 @@ int main() {
     cout << totalCards << '\n';
     return 0;
 }
+
+}  // namespace puzzle04b
+
+
+AOC_PUZZLE_MAIN(04b)
@@ -132,13 +132,23 @@
 // What is the lowest location number that corresponds to any of the initial seed numbers?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+#include "tokenizer.h"
+
 using namespace std;
 using Value = unsigned long;
 
+namespace puzzle05a {
+
+AOC_PUZZLE_STREAMS
+
 
 const bool debug = false;
 
@@ -156,11 +166,25 @@ struct Mapping {
         return source;
     }
 
-    bool read() {
-        string line;
-        getline(cin, line);
+    bool read(aoc::Input& input, bool& bad) {
+        // Reads the next mapping line. Returns false at the blank line (or end of input) ending the section, or if
+        // the line isn't exactly three numbers, in which case `bad` is also set.
+
+        string_view line;
+        input.getline(line);
         if (line.empty()) return false;
-        sscanf(line.c_str(), "%lu %lu %lu", &destinationRangeStart, &sourceRangeStart, &rangeLength);
+
+        uint64_t values[3];
+        size_t   count;
+        if (!aoc::extractUnsigned(line, values, count) || count != 3) {
+            cerr << "Error: Bad mapping line '" << line << "'.\n";
+            bad = true;
+            return false;
+        }
+
+        destinationRangeStart = values[0];
+        sourceRangeStart      = values[1];
+        rangeLength           = values[2];
         return true;
     }
 
@@ -299,74 +323,78 @@ struct GardenData {
 };
 
 
-void readSeeds(const string& line, GardenData& data) {
+void readSeeds(string_view line, GardenData& data) {
     // Read the list of seeds from the input line.
 
     data.seeds.clear();
 
-    auto *ptr = line.c_str();
-    while (ptr) {
-        while (ptr && *ptr && *ptr != ' ') ++ptr;  // Scan to next space.
-        if (!ptr || !*ptr) break;
-        ++ptr;  // Skip the space.
-        data.seeds.push_back(atoi(ptr));
-    }
+    vector<uint64_t> seeds(aoc::maxIntegers(line));
+    size_t count;
+    aoc::extractUnsigned(line, seeds, count);
+    data.seeds.assign(seeds.begin(), seeds.begin() + count);
 }
 
 
-void readMappings(vector<Mapping>& mappings) {
-    // Read a set of mappings from standard input.
+bool readMappings(aoc::Input& input, vector<Mapping>& mappings) {
+    // Read a set of mappings from the puzzle input. Returns false on a bad mapping line.
 
-    string line;
     Mapping mapping;
-    while (mapping.read())
+    bool bad = false;
+    while (mapping.read(input, bad))
         mappings.push_back(mapping);
+    return !bad;
 }
 
 
-bool readSection(GardenData& data) {
+bool readSection(aoc::Input& input, GardenData& data, bool& bad) {
     // Read a section of the input file, which is a set of mappings from one category to another.
     // Each line in the section is a mapping, and each mapping is three integers separated by
     // whitespace: the destination range start, the source range start, and the range length.
+    // Returns false at the end of input or an unknown line, and sets `bad` on a bad mapping line.
 
-    string line;
+    string_view line;
 
     while (true) {
-        if (!getline(cin, line)) return false;
+        if (!input.getline(line)) return false;
         if (!line.empty()) break;
     }
 
     if (line.starts_with("seeds: "))
         readSeeds(line, data);
     else if (line == "seed-to-soil map:")
-        readMappings(data.mappings.seedToSoil);
+        bad = !readMappings(input, data.mappings.seedToSoil);
     else if (line == "soil-to-fertilizer map:")
-        readMappings(data.mappings.soilToFertilizer);
+        bad = !readMappings(input, data.mappings.soilToFertilizer);
     else if (line == "fertilizer-to-water map:")
-        readMappings(data.mappings.fertilizerToWater);
+        bad = !readMappings(input, data.mappings.fertilizerToWater);
     else if (line == "water-to-light map:")
-        readMappings(data.mappings.waterToLight);
+        bad = !readMappings(input, data.mappings.waterToLight);
     else if (line == "light-to-temperature map:")
-        readMappings(data.mappings.lightToTemperature);
+        bad = !readMappings(input, data.mappings.lightToTemperature);
     else if (line == "temperature-to-humidity map:")
-        readMappings(data.mappings.temperatureToHumidity);
+        bad = !readMappings(input, data.mappings.temperatureToHumidity);
     else if (line == "humidity-to-location map:")
-        readMappings(data.mappings.humidityToLocation);
+        bad = !readMappings(input, data.mappings.humidityToLocation);
     else {
         cout << "Unknown line: " << line << '\n';
         return false;
     }
 
-    return true;
+    return !bad;
 }
 
 
-int main() {
+int solve(int argc, char* argv[]) {
     GardenData gardenData;
 
-    while (readSection(gardenData))
+    aoc::Input input;
+    bool bad = false;
+    while (readSection(input, gardenData, bad))
         continue;
 
+    if (bad)
+        return 1;
+
     if (debug) gardenData.dump();
 
     Value nearestLocation = gardenData.nearestLocation();
@@ -375,3 +403,8 @@ int main() {
 
     return 0;
 }
+
+}  // namespace puzzle05a
+
+
+AOC_PUZZLE_MAIN(05a)
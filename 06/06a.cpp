@@ -77,85 +77,342 @@
 // multiply these numbers together?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#if defined(__AVX__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "input.h"
+#include "puzzle.h"
+#include "tokenizer.h"
+
 using namespace std;
 
+namespace puzzle06a {
+
+AOC_PUZZLE_STREAMS
+
+using uint128 = unsigned __int128;
+
+bool verbose = true;   // Cleared with the `--quiet` (`-q`) command-line option.
+
 
-struct RaceData {
-    double length;
-    double record;
+struct RaceBatch {
+    // A set of races, laid out as two parallel contiguous arrays.
+    vector<uint64_t> lengths;
+    vector<uint64_t> records;
+
+    size_t size() const { return lengths.size(); }
 };
 
 
-vector<RaceData> readRaceData() {
-    // Reads in a set of race data from stdin and returns it as a vector of RaceData.
+bool parseUint64(string_view digits, uint64_t& value) {
+    // Parses a string of decimal digits. Returns false if the string is empty, contains a non-digit, or overflows.
+
+    if (digits.empty())
+        return false;
+
+    value = 0;
+    for (auto c : digits) {
+        if (c < '0' || '9' < c)
+            return false;
+        uint64_t digit = c - '0';
+        if (value > (UINT64_MAX - digit) / 10)
+            return false;
+        value = 10*value + digit;
+    }
+    return true;
+}
+
+
+bool readRaceData(RaceBatch& raceData) {
+    // Reads in a set of race data from the puzzle input into the given RaceBatch. Returns false on bad input.
 
-    vector<RaceData> raceData;
-    string line;
-    istringstream(iss);
+    aoc::Input input;
+    string_view line;
 
     // Read in the race lengths.
 
-    getline(cin, line);
-    if (!line.starts_with("Time:")) {
+    if (!input.getline(line) || !line.starts_with("Time:")) {
         cerr << "Error: Expected 'Time:' header line.\n";
-        return {};
+        return false;
     }
 
-    iss.str(line.substr(5));
+    line.remove_prefix(5);
+    raceData.lengths.resize(aoc::maxIntegers(line));
 
-    for(string s; iss >> s; ) {
-        RaceData rd;
-        rd.length = stod(s);
-        rd.record = 0;
-        raceData.push_back(rd);
+    size_t count;
+    if (!aoc::extractUnsigned(line, raceData.lengths, count)) {
+        cerr << "Error: Race length out of range.\n";
+        return false;
     }
 
+    raceData.lengths.resize(count);
+
     // Read in the race record distances.
 
-    getline(cin, line);
-    if (!line.starts_with("Distance:")) {
+    if (!input.getline(line) || !line.starts_with("Distance:")) {
         cerr << "Error: Expected 'Distance:' header line.\n";
-        return {};
+        return false;
     }
 
-    iss.str(line.substr(9));
-    iss.clear();
+    line.remove_prefix(9);
+    raceData.records.resize(aoc::maxIntegers(line));
 
-    auto rdit = raceData.begin();
-    for(string s;  iss >> s;  ++rdit)
-        rdit->record = stod(s);
+    if (!aoc::extractUnsigned(line, raceData.records, count)) {
+        cerr << "Error: Record distance out of range.\n";
+        return false;
+    }
+
+    if (count != raceData.size()) {
+        cerr << "Error: Found " << raceData.size() << " race lengths but " << count << " record distances.\n";
+        return false;
+    }
 
-    return raceData;
+    raceData.records.resize(count);
+
+    return true;
 }
 
 
-int main() {
-    vector<RaceData> raceData = readRaceData();
+uint128 isqrt(uint128 n) {
+    // Returns floor(sqrt(n)). A long double estimate gets us within a few units; the loops then correct it exactly.
+
+    uint128 x = static_cast<uint128>(sqrtl(static_cast<long double>(n)));
+
+    while (x > 0 && x > n / x)
+        --x;
+    while ((x + 1) <= n / (x + 1))
+        ++x;
+
+    return x;
+}
 
-    unsigned long long numWays = 1;
 
-    for (const auto& rd : raceData) {
-        cout << "Time " << rd.length << ", distance " << rd.record << "\n";
+uint64_t waysToWin(uint64_t length, uint64_t record) {
+    // Returns the number of integer hold times that beat the record for the given race. Holding the button for h
+    // milliseconds travels h(T-h) millimeters, so the winning hold times lie strictly between the roots of
+    // h² - Th + D = 0. This is computed exactly in 128-bit integers, where T² always fits.
 
-        // Determine the minimum time to press the charge button to beat the record.
-        double minPress = (rd.length - sqrt(rd.length*rd.length - 4*rd.record)) / 2;
+    const uint128 T = length;
+    const uint128 D = record;
 
-        if (minPress == ceil(minPress)) // Matching the current record exactly is not enough.
+    if (T*T <= 4*D)
+        return 0;   // The best possible distance does not beat the record.
+
+    uint128 minPress = (T - isqrt(T*T - 4*D)) / 2;
+
+    // Matching the current record exactly is not enough.
+    while (minPress <= T/2 && minPress * (T - minPress) <= D)
+        ++minPress;
+    while (minPress > 0 && (minPress - 1) * (T - minPress + 1) > D)
+        --minPress;
+
+    if (minPress > T/2)
+        return 0;
+
+    return static_cast<uint64_t>(T - 2*minPress + 1);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Batch Evaluation
+//
+// For large numbers of races, the lower roots are first estimated in double precision for a whole block of races at a
+// time, using SIMD square roots where available. Each estimate is then corrected exactly in integer arithmetic. An
+// estimate can be poor when T² is far beyond 2^53 and the discriminant is small, so if the correction doesn't settle
+// within a few steps we fall back to the exact scalar solver above.
+
+const size_t blockSize = 1024;
+const int    maxCorrectionSteps = 4;
+
+
+void estimateMinPress(const double* lengths, const double* records, double* minPress, size_t count) {
+    // Computes minPress[i] = (T - sqrt(max(T² - 4D, 0))) / 2 for each race.
+
+    size_t i = 0;
+
+#if defined(__AVX__)
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d zero = _mm256_setzero_pd();
+
+    for (;  i + 4 <= count;  i += 4) {
+        __m256d T = _mm256_loadu_pd(lengths + i);
+        __m256d D = _mm256_loadu_pd(records + i);
+        __m256d disc = _mm256_max_pd(_mm256_sub_pd(_mm256_mul_pd(T, T), _mm256_mul_pd(four, D)), zero);
+        _mm256_storeu_pd(minPress + i, _mm256_mul_pd(half, _mm256_sub_pd(T, _mm256_sqrt_pd(disc))));
+    }
+#elif defined(__SSE2__)
+    const __m128d four = _mm_set1_pd(4.0);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d zero = _mm_setzero_pd();
+
+    for (;  i + 2 <= count;  i += 2) {
+        __m128d T = _mm_loadu_pd(lengths + i);
+        __m128d D = _mm_loadu_pd(records + i);
+        __m128d disc = _mm_max_pd(_mm_sub_pd(_mm_mul_pd(T, T), _mm_mul_pd(four, D)), zero);
+        _mm_storeu_pd(minPress + i, _mm_mul_pd(half, _mm_sub_pd(T, _mm_sqrt_pd(disc))));
+    }
+#endif
+
+    for (;  i < count;  ++i) {
+        double disc = max(lengths[i]*lengths[i] - 4*records[i], 0.0);
+        minPress[i] = 0.5 * (lengths[i] - sqrt(disc));
+    }
+}
+
+
+uint64_t correctWays(uint64_t length, uint64_t record, double estimate) {
+    // Given an estimate of the minimum winning hold time, returns the exact number of ways to win.
+
+    const uint128  T = length;
+    const uint128  D = record;
+    const uint64_t halfT = length / 2;   // The hold time that travels farthest.
+
+    auto wins = [&](uint64_t h) { return uint128(h) * (T - h) > D; };
+
+    uint64_t minPress = (estimate <= 0) ? 0 : (estimate >= double(halfT)) ? halfT : uint64_t(estimate);
+
+    for (int step = 0;  step < maxCorrectionSteps;  ++step) {
+        if (!wins(minPress)) {
+            if (minPress == halfT)
+                return 0;   // Even the best hold time doesn't beat the record.
             ++minPress;
+        } else if (minPress > 0 && wins(minPress - 1)) {
+            --minPress;
+        } else {
+            return length - 2*minPress + 1;
+        }
+    }
+
+    return waysToWin(length, record);
+}
+
+
+void batchWaysToWin(const uint64_t* lengths, const uint64_t* records, uint64_t* ways, size_t count) {
+    // Computes the number of ways to win each of the given races, a block at a time.
+
+    double blockLengths[blockSize];
+    double blockRecords[blockSize];
+    double blockEstimates[blockSize];
+
+    for (size_t start = 0;  start < count;  start += blockSize) {
+        size_t n = min(blockSize, count - start);
+
+        for (size_t i = 0;  i < n;  ++i) {
+            blockLengths[i] = double(lengths[start + i]);
+            blockRecords[i] = double(records[start + i]);
+        }
+
+        estimateMinPress(blockLengths, blockRecords, blockEstimates, n);
+
+        for (size_t i = 0;  i < n;  ++i)
+            ways[start + i] = correctWays(lengths[start + i], records[start + i], blockEstimates[i]);
+    }
+}
+
+
+uint64_t mulMod(uint64_t a, uint64_t b, uint64_t modulus) {
+    // Multiplies modulo the given modulus. A modulus of zero means plain (wrapping) 64-bit arithmetic.
+    return modulus ? uint64_t(uint128(a) * b % modulus) : a * b;
+}
 
-        minPress = ceil(minPress);
-        double distance = minPress * (rd.length - minPress);
-        if (distance <= rd.record) continue; // No way to beat the record.
 
-        numWays *= (rd.length - 2*minPress + 1);
+uint64_t productOfWays(const RaceBatch& races, uint64_t modulus, unsigned numThreads) {
+    // Returns the product of the number of ways to win each race, reduced by the given modulus (if non-zero). The
+    // races are split into one contiguous slice per thread, and the per-thread products are combined at the end.
+
+    const uint64_t one = modulus ? 1 % modulus : 1;
+    const size_t   count = races.size();
+
+    numThreads = max(1u, min<unsigned>(numThreads, (count + blockSize - 1) / blockSize));
+
+    vector<uint64_t> partials(numThreads, one);
+    vector<thread>   threads;
+
+    auto work = [&](unsigned t) {
+        size_t begin = count * t / numThreads;
+        size_t end   = count * (t + 1) / numThreads;
+
+        uint64_t ways[blockSize];
+        uint64_t product = one;
+
+        for (size_t start = begin;  start < end;  start += blockSize) {
+            size_t n = min(blockSize, end - start);
+            batchWaysToWin(races.lengths.data() + start, races.records.data() + start, ways, n);
+            for (size_t i = 0;  i < n;  ++i)
+                product = mulMod(product, ways[i], modulus);
+        }
+
+        partials[t] = product;
+    };
+
+    for (unsigned t = 1;  t < numThreads;  ++t)
+        threads.emplace_back(work, t);
+    work(0);
+
+    for (auto& t : threads)
+        t.join();
+
+    uint64_t product = one;
+    for (auto partial : partials)
+        product = mulMod(product, partial, modulus);
+
+    return product;
+}
+
+
+int solve(int argc, char* argv[]) {
+    uint64_t modulus    = 0;                                        // Set with `--modulus <m>`.
+    unsigned numThreads = max(1u, thread::hardware_concurrency());  // Set with `--threads <n>` (0 for all hardware).
+
+    for (int i = 1;  i < argc;  ++i) {
+        string_view arg {argv[i]};
+        if (arg == "-q" || arg == "--quiet") {
+            verbose = false;
+        } else if ((arg == "--modulus" || arg == "--threads") && i+1 < argc) {
+            uint64_t value;
+            if (!parseUint64(argv[++i], value) || (arg == "--threads" && value > UINT_MAX)) {
+                cerr << "Error: Bad value '" << argv[i] << "' for option '" << arg << "'.\n";
+                return 1;
+            }
+            if (arg == "--modulus")
+                modulus = value;
+            else if (value > 0)
+                numThreads = value;
+        } else {
+            cerr << "Error: Unrecognized option '" << arg << "'.\n";
+            return 1;
+        }
+    }
+
+    RaceBatch raceData;
+    if (!readRaceData(raceData))
+        return 1;
+
+    if (verbose) {
+        for (size_t i = 0;  i < raceData.size();  ++i)
+            cout << "Time " << raceData.lengths[i] << ", distance " << raceData.records[i] << "\n";
     }
 
-    cout << "\nNumber of ways to beat the record: " << numWays << "\n";
+    cout << "\nNumber of ways to beat the record: " << productOfWays(raceData, modulus, numThreads) << "\n";
 
     return 0;
 }
+
+}  // namespace puzzle06a
+
+
+AOC_PUZZLE_MAIN(06a)
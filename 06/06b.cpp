@@ -100,78 +100,372 @@
 // How many ways can you beat the record in this one much longer race?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+
 using namespace std;
 
+namespace puzzle06b {
+
+AOC_PUZZLE_STREAMS
+
+using uint128 = unsigned __int128;
+
 
 struct RaceData {
-    double length;
-    double record;
+    string length;  // Decimal digits of the race length.
+    string record;  // Decimal digits of the record distance.
 };
 
 
-RaceData readRaceData() {
-    // Reads in a set of race data from stdin and returns it as a vector of RaceData.
+bool readDigits(string_view text, string& digits) {
+    // Collects the decimal digits of a number written with spaces between them. Returns false if the text holds
+    // anything other than digits and whitespace, or no digits at all.
+
+    for (auto c : text) {
+        if ('0' <= c && c <= '9')
+            digits += c;
+        else if (c != ' ' && c != '\t' && c != '\r')
+            return false;
+    }
+    return !digits.empty();
+}
+
+
+bool readRaceData(RaceData& raceData) {
+    // Reads in the race data from the puzzle input, ignoring the spaces between digits. Returns false on bad input.
 
-    string line;
+    aoc::Input input;
+    string_view line;
 
     // Read in the race lengths.
 
-    getline(cin, line);
-    if (!line.starts_with("Time:")) {
+    if (!input.getline(line) || !line.starts_with("Time:")) {
         cerr << "Error: Expected 'Time:' header line.\n";
-        return {};
+        return false;
     }
 
-    string timeString;
-
-    for(auto sit = line.begin() + 5;  sit < line.end();  ++sit) {
-        if (*sit != ' ')
-            timeString += *sit;
+    if (!readDigits(line.substr(5), raceData.length)) {
+        cerr << "Error: Bad race length '" << line.substr(5) << "'.\n";
+        return false;
     }
 
     // Read in the race record distances.
 
-    getline(cin, line);
-    if (!line.starts_with("Distance:")) {
+    if (!input.getline(line) || !line.starts_with("Distance:")) {
         cerr << "Error: Expected 'Distance:' header line.\n";
-        return {};
+        return false;
     }
 
-    string recordString;
+    if (!readDigits(line.substr(9), raceData.record)) {
+        cerr << "Error: Bad record distance '" << line.substr(9) << "'.\n";
+        return false;
+    }
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Exact 128-bit Solver
+//
+// Holding the button for h milliseconds of a race of length T travels h(T-h) millimeters, so the winning hold times are
+// the integers strictly between the roots of h² - Th + D = 0. Rather than solving this in floating point (which loses
+// precision once T² exceeds 2^53), we take the integer square root of the discriminant and then nudge the lower bound
+// onto the first winning hold time. For 64-bit race lengths, T² always fits in 128 bits.
+
+bool parseUint64(const string& digits, uint64_t& value) {
+    // Parses a string of decimal digits. Returns false if the string is empty, contains a non-digit, or overflows.
+
+    if (digits.empty())
+        return false;
 
-    for (auto sit = line.begin() + 9;  sit < line.end();  ++sit) {
-        if (*sit != ' ')
-            recordString += *sit;
+    value = 0;
+    for (auto c : digits) {
+        if (c < '0' || '9' < c)
+            return false;
+        uint64_t digit = c - '0';
+        if (value > (UINT64_MAX - digit) / 10)
+            return false;
+        value = 10*value + digit;
     }
+    return true;
+}
+
+
+uint128 isqrt(uint128 n) {
+    // Returns floor(sqrt(n)). A long double estimate gets us within a few units; the loops then correct it exactly.
 
-    return { stod(timeString), stod(recordString) };
+    uint128 x = static_cast<uint128>(sqrtl(static_cast<long double>(n)));
+
+    while (x > 0 && x > n / x)
+        --x;
+    while ((x + 1) <= n / (x + 1))
+        ++x;
+
+    return x;
 }
 
 
-int main() {
-    RaceData raceData = readRaceData();
+uint64_t waysToWin(uint64_t length, uint64_t record) {
+    // Returns the number of integer hold times that beat the record for the given race.
 
-    unsigned long long numWays = 0;
+    const uint128 T = length;
+    const uint128 D = record;
 
-    cout << "Time " << raceData.length << ", distance " << raceData.record << "\n";
+    if (T*T <= 4*D)
+        return 0;   // The best possible distance does not beat the record.
 
-    // Determine the minimum time to press the charge button to beat the record.
-    double minPress = (raceData.length - sqrt(raceData.length*raceData.length - 4*raceData.record)) / 2;
+    uint128 minPress = (T - isqrt(T*T - 4*D)) / 2;
 
-    if (minPress == ceil(minPress)) // Matching the current record exactly is not enough.
+    // Matching the current record exactly is not enough.
+    while (minPress <= T/2 && minPress * (T - minPress) <= D)
         ++minPress;
+    while (minPress > 0 && (minPress - 1) * (T - minPress + 1) > D)
+        --minPress;
+
+    if (minPress > T/2)
+        return 0;
+
+    return static_cast<uint64_t>(T - 2*minPress + 1);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Arbitrary-Precision Fallback
+//
+// Race lengths or records that don't fit in 64 bits are handled with a minimal unsigned big number type holding 32-bit
+// limbs, least significant first. It supports just the operations the solver needs.
+
+class BigUnsigned {
+  public:
+    BigUnsigned(uint64_t value = 0) {
+        while (value) {
+            limbs.push_back(static_cast<uint32_t>(value));
+            value >>= 32;
+        }
+    }
+
+    static bool fromDecimal(const string& digits, BigUnsigned& result) {
+        // Parses a string of decimal digits. Returns false if the string is empty or contains a non-digit.
+
+        if (digits.empty())
+            return false;
+
+        result = BigUnsigned();
+        for (auto c : digits) {
+            if (c < '0' || '9' < c)
+                return false;
+            result = result * 10 + BigUnsigned(c - '0');
+        }
+        return true;
+    }
+
+    string toDecimal() const {
+        if (limbs.empty())
+            return "0";
+
+        // Peel off nine decimal digits at a time.
+        string result;
+        BigUnsigned n = *this;
+        while (!n.limbs.empty()) {
+            uint32_t chunk = n.divideSmall(1'000'000'000);
+            for (int i = 0;  i < 9;  ++i) {
+                result += char('0' + chunk % 10);
+                chunk /= 10;
+                if (n.limbs.empty() && chunk == 0)
+                    break;
+            }
+        }
+        reverse(result.begin(), result.end());
+        return result;
+    }
+
+    bool isZero() const { return limbs.empty(); }
+
+    friend int compare(const BigUnsigned& a, const BigUnsigned& b) {
+        if (a.limbs.size() != b.limbs.size())
+            return a.limbs.size() < b.limbs.size() ? -1 : 1;
+        for (size_t i = a.limbs.size();  i-- > 0; ) {
+            if (a.limbs[i] != b.limbs[i])
+                return a.limbs[i] < b.limbs[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    friend bool operator< (const BigUnsigned& a, const BigUnsigned& b) { return compare(a, b) <  0; }
+    friend bool operator<=(const BigUnsigned& a, const BigUnsigned& b) { return compare(a, b) <= 0; }
+    friend bool operator> (const BigUnsigned& a, const BigUnsigned& b) { return compare(a, b) >  0; }
 
-    minPress = ceil(minPress);
-    double distance = minPress * (raceData.length - minPress);
-    if (distance > raceData.record)
-        numWays = (raceData.length - 2*minPress + 1);
+    friend BigUnsigned operator+(const BigUnsigned& a, const BigUnsigned& b) {
+        BigUnsigned result;
+        uint64_t carry = 0;
+        for (size_t i = 0;  i < max(a.limbs.size(), b.limbs.size()) || carry;  ++i) {
+            uint64_t sum = carry + a.limb(i) + b.limb(i);
+            result.limbs.push_back(static_cast<uint32_t>(sum));
+            carry = sum >> 32;
+        }
+        return result;
+    }
+
+    friend BigUnsigned operator-(const BigUnsigned& a, const BigUnsigned& b) {
+        // Requires a >= b.
+        BigUnsigned result;
+        int64_t borrow = 0;
+        for (size_t i = 0;  i < a.limbs.size();  ++i) {
+            int64_t diff = int64_t(a.limbs[i]) - int64_t(b.limb(i)) - borrow;
+            borrow = (diff < 0) ? 1 : 0;
+            result.limbs.push_back(static_cast<uint32_t>(diff + (borrow << 32)));
+        }
+        result.trim();
+        return result;
+    }
+
+    friend BigUnsigned operator*(const BigUnsigned& a, const BigUnsigned& b) {
+        if (a.isZero() || b.isZero())
+            return {};
+
+        BigUnsigned result;
+        result.limbs.assign(a.limbs.size() + b.limbs.size(), 0);
+        for (size_t i = 0;  i < a.limbs.size();  ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0;  j < b.limbs.size() || carry;  ++j) {
+                uint64_t product = result.limbs[i+j] + carry + uint64_t(a.limbs[i]) * b.limb(j);
+                result.limbs[i+j] = static_cast<uint32_t>(product);
+                carry = product >> 32;
+            }
+        }
+        result.trim();
+        return result;
+    }
+
+    BigUnsigned shiftedRight(int bits) const {
+        // Shifts right by 0-31 bits.
+        BigUnsigned result = *this;
+        if (bits == 0)
+            return result;
+        for (size_t i = 0;  i < result.limbs.size();  ++i)
+            result.limbs[i] = (result.limbs[i] >> bits) | static_cast<uint32_t>(uint64_t(limb(i+1)) << (32 - bits));
+        result.trim();
+        return result;
+    }
+
+    int bitLength() const {
+        if (limbs.empty())
+            return 0;
+        return 32 * (limbs.size() - 1) + (32 - __builtin_clz(limbs.back()));
+    }
+
+    static BigUnsigned powerOfTwo(int exponent) {
+        BigUnsigned result;
+        result.limbs.assign(exponent / 32 + 1, 0);
+        result.limbs.back() = uint32_t(1) << (exponent % 32);
+        return result;
+    }
 
-    cout << "\nNumber of ways to beat the record: " << numWays << "\n";
+  private:
+    uint32_t limb(size_t i) const { return i < limbs.size() ? limbs[i] : 0; }
+
+    void trim() {
+        while (!limbs.empty() && limbs.back() == 0)
+            limbs.pop_back();
+    }
+
+    uint32_t divideSmall(uint32_t divisor) {
+        // Divides in place, returning the remainder.
+        uint64_t remainder = 0;
+        for (size_t i = limbs.size();  i-- > 0; ) {
+            uint64_t current = (remainder << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(current / divisor);
+            remainder = current % divisor;
+        }
+        trim();
+        return static_cast<uint32_t>(remainder);
+    }
+
+    vector<uint32_t> limbs;
+};
+
+
+BigUnsigned isqrt(BigUnsigned n) {
+    // Returns floor(sqrt(n)) using the binary digit-by-digit method, which needs only shifts, adds and subtracts.
+
+    BigUnsigned result;
+    if (n.isZero())
+        return result;
+
+    BigUnsigned bit = BigUnsigned::powerOfTwo((n.bitLength() - 1) & ~1);  // Highest power of four <= n.
+
+    while (!bit.isZero()) {
+        BigUnsigned trial = result + bit;
+        if (trial <= n) {
+            n = n - trial;
+            result = result.shiftedRight(1) + bit;
+        } else {
+            result = result.shiftedRight(1);
+        }
+        bit = bit.shiftedRight(2);
+    }
+
+    return result;
+}
+
+
+BigUnsigned waysToWin(const BigUnsigned& T, const BigUnsigned& D) {
+    // Same as the 128-bit solver above, for arbitrarily long race lengths and records.
+
+    const BigUnsigned one {1};
+    const BigUnsigned halfT = T.shiftedRight(1);
+
+    if (T*T <= D*4)
+        return {};
+
+    BigUnsigned minPress = (T - isqrt(T*T - D*4)).shiftedRight(1);
+
+    while (minPress <= halfT && minPress * (T - minPress) <= D)
+        minPress = minPress + one;
+    while (!minPress.isZero() && (minPress - one) * (T - minPress + one) > D)
+        minPress = minPress - one;
+
+    if (minPress > halfT)
+        return {};
+
+    return T + one - minPress - minPress;
+}
+
+
+int solve(int argc, char* argv[]) {
+    RaceData raceData;
+    if (!readRaceData(raceData))
+        return 1;
+
+    cout << "Time " << raceData.length << ", distance " << raceData.record << "\n";
+
+    uint64_t length, record;
+    BigUnsigned bigLength, bigRecord;
+
+    if (parseUint64(raceData.length, length) && parseUint64(raceData.record, record)) {
+        cout << "\nNumber of ways to beat the record: " << waysToWin(length, record) << "\n";
+    } else if (BigUnsigned::fromDecimal(raceData.length, bigLength)
+               && BigUnsigned::fromDecimal(raceData.record, bigRecord)) {
+        cout << "\nNumber of ways to beat the record: " << waysToWin(bigLength, bigRecord).toDecimal() << "\n";
+    } else {
+        cerr << "Error: Bad race data.\n";
+        return 1;
+    }
 
     return 0;
 }
+
+}  // namespace puzzle06b
+
+
+AOC_PUZZLE_MAIN(06b)
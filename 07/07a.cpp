@@ -84,30 +84,41 @@
 //----------------------------------------------------------------------------------------------------------------------
 
 #include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <span>
 #include <sstream>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+#include "tokenizer.h"
+
 using namespace std;
 
-const bool verbose = true;
+namespace puzzle07a {
+
+AOC_PUZZLE_STREAMS
+
+bool verbose = true;   // Cleared with the `--quiet` (`-q`) command-line option.
 const int  numCards = 5;
 
 
 class Hand {
   public:
-    Hand(string desc) {
-        auto sit = desc.begin();
-
+    Hand(string_view desc) {
         for (int i = 0;  i < 5;  ++i)
-            cards[i] = *sit++;
-
-        ++sit; // Skip space.
+            cards[i] = desc[i];
 
-        bid = 0;
-        while (sit != desc.end())
-            bid = 10*bid + (*sit++ - '0');
+        // The bid follows the cards (which may themselves be digits).
+        uint64_t bidValue = 0;
+        size_t   count;
+        aoc::extractUnsigned(desc.substr(min<size_t>(5, desc.size())), span(&bidValue, 1), count);
+        bid = bidValue;
 
         calculateRank();
     }
@@ -174,47 +185,123 @@ bool compareHands(const Hand& h1, const Hand& h2) {
 }
 
 
-int main() {
-    string line;
+class Report {
+    // Collects verbose output in a single preallocated buffer, formatting numbers with `to_chars()`
+    // instead of stream insertion. The buffer is written out in one piece with `flush()`, or earlier
+    // if it fills up.
+
+  public:
+    static const size_t maxLineLength = 80;
+
+    Report(size_t numLines) : buffer((numLines + 4) * maxLineLength), end(buffer.data()) {}
+
+    ~Report() { flush(); }
+
+    Report& operator<<(string_view s) {
+        reserve(s.size());
+        memcpy(end, s.data(), s.size());
+        end += s.size();
+        return *this;
+    }
+
+    Report& operator<<(char c) {
+        reserve(1);
+        *end++ = c;
+        return *this;
+    }
+
+    Report& operator<<(long value) {
+        reserve(24);
+        end = to_chars(end, buffer.data() + buffer.size(), value).ptr;
+        return *this;
+    }
+
+    void hand(const Hand& hand, int rank = 0) {
+        // Appends a one-line description of the given hand. If rank is zero, it is omitted.
+        reserve(maxLineLength);
+        *this << "Hand: ";
+        if (rank > 0)
+            *this << "rank " << long(rank) << ", ";
+        *this << string_view(hand.cards, numCards)
+              << ", bid " << long(hand.bid)
+              << ", score " << long(hand.score) << '\n';
+    }
+
+    void flush() {
+        cout.write(buffer.data(), end - buffer.data());
+        cout.flush();
+        end = buffer.data();
+    }
+
+  private:
+    void reserve(size_t size) {
+        if (size_t(buffer.data() + buffer.size() - end) < size)
+            flush();
+    }
+
+    vector<char> buffer;
+    char*        end;
+};
+
+
+int solve(int argc, char* argv[]) {
+    for (int i = 1;  i < argc;  ++i) {
+        string_view arg {argv[i]};
+        if (arg == "-q" || arg == "--quiet")
+            verbose = false;
+        else if (arg == "-v" || arg == "--verbose")
+            verbose = true;
+        else {
+            cerr << "Error: Unrecognized option '" << arg << "'.\n";
+            return 1;
+        }
+    }
+
+    aoc::Input input;
+    string_view line;
 
     vector<Hand> hands;
 
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
         hands.push_back({line});
     }
 
+    // Size the report buffer for both passes over the hands (a minimal buffer when quiet).
+    Report report(verbose ? 2*hands.size() : 0);
+
     if (verbose) {
-        for (const auto& hand : hands) {
-            cout << "Hand: " << hand.cards[0] << hand.cards[1] << hand.cards[2] << hand.cards[3] << hand.cards[4]
-                 << ", bid " << hand.bid
-                 << ", score " << hand.score << '\n';
-        }
-        cout << '\n';
+        for (const auto& hand : hands)
+            report.hand(hand);
+        report << '\n';
     }
 
     sort(hands.begin(), hands.end(), compareHands);
 
     if (verbose)
-        cout << "--------------------------------------------------------------------------------\n\n";
+        report << "--------------------------------------------------------------------------------\n\n";
 
     long totalWinnings = 0;
     int  numHands = hands.size();
 
     for (int rank = 1;  rank <= numHands;  ++rank) {
         const Hand& hand = hands[rank - 1];
-        if (verbose) {
-            cout << "Hand: rank " << rank << ", " << hand.cards[0] << hand.cards[1] << hand.cards[2] << hand.cards[3] << hand.cards[4]
-                 << ", bid " << hand.bid
-                 << ", score " << hand.score << '\n';
-        }
+        if (verbose)
+            report.hand(hand, rank);
 
         totalWinnings += hand.bid * rank;
     }
 
-    if (verbose)
-        cout << "\n\n";
+    if (verbose) {
+        report << "\n\n";
+        report.flush();
+    }
 
     cout << "Total winnings: " << totalWinnings << '\n';
 
     return 0;
 }
+
+}  // namespace puzzle07a
+
+
+AOC_PUZZLE_MAIN(07a)
@@ -47,13 +47,20 @@
 //----------------------------------------------------------------------------------------------------------------------
 
 #include <iostream>
-#include <sstream>
+#include <spanstream>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 
+#include "input.h"
+#include "puzzle.h"
+
 using namespace std;
 
+namespace puzzle08a {
+
+AOC_PUZZLE_STREAMS
+
 const bool verbose = false;
 
 
@@ -114,10 +121,11 @@ class Navigator {
 };
 
 
-int main() {
-    string line;
+int solve(int argc, char* argv[]) {
+    aoc::Input input;
+    string_view line;
 
-    getline(cin, line);
+    input.getline(line);
     Navigator navigator(line);
 
     if (verbose)
@@ -128,12 +136,12 @@ int main() {
     nodes.insert({"AAA", Node("AAA")});
     nodes.insert({"ZZZ", Node("ZZZ")});
 
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
 
         if (line.empty())
             continue;
 
-        istringstream iss(line);
+        ispanstream iss(line);
 
         string token;
         string nodeName;
@@ -172,3 +180,8 @@ int main() {
 
     return 0;
 }
+
+}  // namespace puzzle08a
+
+
+AOC_PUZZLE_MAIN(08a)
@@ -91,13 +91,21 @@
 //----------------------------------------------------------------------------------------------------------------------
 
 #include <iostream>
-#include <sstream>
+#include <spanstream>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
+
+#include "input.h"
+#include "puzzle.h"
 
 using namespace std;
 
+namespace puzzle08b {
+
+AOC_PUZZLE_STREAMS
+
 const bool verbose = false;
 const bool showProgress = true;
 
@@ -203,10 +211,11 @@ class Navigator {
 };
 
 
-int main() {
-    string line;
+int solve(int argc, char* argv[]) {
+    aoc::Input input;
+    string_view line;
 
-    getline(cin, line);
+    input.getline(line);
     Navigator navigator(line);
 
     if (verbose)
@@ -214,12 +223,12 @@ int main() {
 
     unordered_map<string, Node> nodes;
 
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
 
         if (line.empty())
             continue;
 
-        istringstream iss(line);
+        ispanstream iss(line);
 
         string token;
         string nodeName;
@@ -261,3 +270,8 @@ int main() {
 
     return 0;
 }
+
+}  // namespace puzzle08b
+
+
+AOC_PUZZLE_MAIN(08b)
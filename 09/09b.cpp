@@ -120,61 +120,336 @@
 // these extrapolated values?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+#include "tokenizer.h"
+
 using namespace std;
 
+namespace puzzle09b {
+
+AOC_PUZZLE_STREAMS
+
+
+class ExtrapolationTable {
+    // Repeatedly differencing a sequence of n values until the differences are constant, and then extending the
+    // pyramid, is the same as extending the unique polynomial of degree < n through the sequence. That makes the
+    // prior value a fixed weighted sum of the inputs:
+    //
+    //     a[-1] = sum_i (-1)^i C(n,i+1) a[i]
+    //
+    // This table caches the signed binomial weights for each sequence length.
+
+  public:
+    static const size_t maxLength = 66;   // Beyond this, the binomial weights no longer fit in an int64_t.
+
+    const vector<int64_t>& weights(size_t n) {
+        while (rows.size() <= n) {
+            const size_t length = rows.size();
+            vector<int64_t> row(length);
+
+            // Weight i is (-1)^i C(n,i+1), for i in [0,n).
+            __int128 binomial = length;   // C(n,i+1)
+            for (size_t i = 0;  i < length;  ++i) {
+                row[i] = static_cast<int64_t>((i % 2) ? -binomial : binomial);
+                binomial = binomial * (length - i - 1) / (i + 2);
+            }
+
+            rows.push_back(row);
+        }
+
+        return rows[n];
+    }
+
+  private:
+    vector<vector<int64_t>> rows;
+};
+
+
+class DifferencePyramid {
+    // Extrapolates a sequence both forwards and backwards in a single pass. Each level of differences overwrites the
+    // previous one within a buffer that is reused from sequence to sequence, so no allocation happens once the buffer
+    // has grown to the longest sequence. The next value is the sum of the last entries of every level, and the prior
+    // value is the alternating sum of the first entries.
+
+  public:
+    bool extrapolate(const vector<int64_t>& seq, int64_t& prior, int64_t& next) {
+        // Returns false if the sequence is empty or a difference or result overflows.
+
+        size_t length = seq.size();
+        if (length == 0)
+            return false;
+
+        buffer.assign(seq.begin(), seq.end());
+        int64_t* level = buffer.data();
+
+        bool negate   = false;
+        bool overflow = false;
+
+        prior = 0;
+        next  = 0;
+
+        while (true) {
+            overflow |= __builtin_add_overflow(next, level[length-1], &next);
+            overflow |= negate ? __builtin_sub_overflow(prior, level[0], &prior)
+                               : __builtin_add_overflow(prior, level[0], &prior);
+
+            bool isConst = true;
+            for (size_t i = 1;  i < length;  ++i)
+                isConst &= (level[i] == level[0]);
 
-long priorInSeq(const vector<long>& seq) {
-    bool isConst = true;
-    long v = seq[0];
+            if (isConst)
+                break;
 
-    for (int i=1;  isConst && i < seq.size();  ++i)
-        isConst = (seq[i] == v);
+            for (size_t i = 0;  i + 1 < length;  ++i)
+                overflow |= __builtin_sub_overflow(level[i+1], level[i], &level[i]);
 
-    if (isConst)
-        return seq[0];
+            --length;
+            negate = !negate;
+        }
+
+        return !overflow;
+    }
+
+  private:
+    vector<int64_t> buffer;
+};
+
+
+bool priorInSeq(const vector<int64_t>& seq, int64_t& prior) {
+    // Computes the prior value of the sequence as a dot product with the binomial weights. Returns false if the
+    // sequence is empty or the result overflows.
 
-    vector<long> diffs;
+    static ExtrapolationTable table;
 
-    for (auto i=1;  i <  seq.size();  ++i) {
-        long diff = seq[i] - seq[i-1];
-        diffs.push_back(diff);
+    const size_t n = seq.size();
+    if (n == 0)
+        return false;
+
+    if (n > ExtrapolationTable::maxLength) {
+        // The weights no longer fit in 64 bits, so extrapolate with overflow-checked differences instead.
+        static DifferencePyramid pyramid;
+        int64_t next;
+        return pyramid.extrapolate(seq, prior, next);
     }
 
-    const auto priorDiff = priorInSeq(diffs);
+    const auto& weights = table.weights(n);
+
+    // The weight magnitudes sum to less than 2^n, so if every value is below 2^(62-n) in magnitude, a plain 64-bit dot
+    // product cannot overflow. Otherwise, accumulate in checked 128-bit arithmetic.
+
+    uint64_t magnitudeBits = 0;
+    for (auto v : seq)
+        magnitudeBits |= (v < 0) ? -static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+
+    if (n < 62 && magnitudeBits < (uint64_t(1) << (62 - n))) {
+        int64_t sum = 0;
+        for (size_t i = 0;  i < n;  ++i)
+            sum += weights[i] * seq[i];
+        prior = sum;
+        return true;
+    }
 
-    return seq.front() - priorDiff;
+    __int128 sum = 0;
+    for (size_t i = 0;  i < n;  ++i) {
+        if (__builtin_add_overflow(sum, __int128(weights[i]) * seq[i], &sum))
+            return false;
+    }
+
+    if (sum < INT64_MIN || INT64_MAX < sum)
+        return false;
+
+    prior = static_cast<int64_t>(sum);
+    return true;
 }
 
 
-int main() {
-    string line;
-    long sum = 0;
+const char* parseSequence(const char* p, const char* end, vector<int64_t>& seq) {
+    // Parses one line of signed integers into seq. Returns a pointer just past the end of the line, or nullptr if a
+    // number overflows.
+
+    auto newline = static_cast<const char*>(memchr(p, '\n', end - p));
+    const string_view line(p, (newline ? newline : end) - p);
+
+    seq.resize(aoc::maxIntegers(line));
 
-    while (getline(cin, line)) {
-        vector<long> seq;
+    size_t count;
+    if (!aoc::extractIntegers(line, seq, count))
+        return nullptr;
 
-        istringstream iss(line);
+    seq.resize(count);
+    return newline ? newline + 1 : end;
+}
+
+
+class ResultStream {
+    // Optionally writes each extrapolated value to a file, either as CSV text (one line per sequence) or as raw
+    // native-endian 64-bit integers. Output is staged in a large buffer and written out in big pieces.
 
-        long num;
-        while (iss >> num)
-            seq.push_back(num);
+  public:
+    enum class Format { None, CSV, Binary };
 
-        cout << "Sequence:";
-        for (auto n : seq) {
-            cout << ' ' << n;
+    ~ResultStream() { flush(); }
+
+    bool open(Format format, const char* path, string_view header) {
+        this->format = format;
+        file.open(path, ios::binary);
+        if (!file)
+            return false;
+        buffer.reserve(bufferSize);
+        if (format == Format::CSV) {
+            buffer.append(header);
+            buffer += '\n';
+        }
+        return true;
+    }
+
+    bool isOpen() const { return format != Format::None; }
+
+    void write(int64_t value) {
+        if (format == Format::Binary) {
+            buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        } else if (format == Format::CSV) {
+            char digits[24];
+            buffer.append(digits, to_chars(digits, digits + sizeof(digits), value).ptr);
+        }
+    }
+
+    void endRecord() {
+        if (format == Format::CSV)
+            buffer += '\n';
+        if (buffer.size() >= bufferSize)
+            flush();
+    }
+
+    void separator() {
+        if (format == Format::CSV)
+            buffer += ',';
+    }
+
+    void flush() {
+        if (format != Format::None)
+            file.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+  private:
+    static const size_t bufferSize = 1 << 20;
+
+    Format   format {Format::None};
+    ofstream file;
+    string   buffer;
+};
+
+
+int solve(int argc, char* argv[]) {
+    bool both    = false;   // Set with `--both` to extrapolate in both directions with a DifferencePyramid.
+    bool verbose = true;    // Cleared with `--quiet` (`-q`) to skip the per-sequence report.
+
+    ResultStream::Format resultFormat = ResultStream::Format::None;
+    const char*          resultPath = nullptr;
+
+    for (int i = 1;  i < argc;  ++i) {
+        string_view arg {argv[i]};
+        if (arg == "--both")
+            both = true;
+        else if (arg == "-q" || arg == "--quiet")
+            verbose = false;
+        else if ((arg == "--csv" || arg == "--binary") && i+1 < argc) {
+            resultFormat = (arg == "--csv") ? ResultStream::Format::CSV : ResultStream::Format::Binary;
+            resultPath = argv[++i];
+        } else {
+            cerr << "Error: Unrecognized option '" << arg << "'.\n";
+            return 1;
+        }
+    }
+
+    ResultStream results;
+    if (resultPath && !results.open(resultFormat, resultPath, both ? "prior,next" : "prior")) {
+        cerr << "Error: Could not open '" << resultPath << "' for writing.\n";
+        return 1;
+    }
+
+    const aoc::Input input;
+    const char*  inputEnd = input.data() + input.size();
+
+    int64_t sum = 0;
+    int64_t otherSum = 0;   // Sum of the values extrapolated in the other direction, with `--both`.
+
+    DifferencePyramid pyramid;
+    vector<int64_t> seq;
+
+    for (const char* p = input.data();  p < inputEnd; ) {
+        p = parseSequence(p, inputEnd, seq);
+        if (!p) {
+            cerr << "Error: Malformed sequence input.\n";
+            return 1;
+        }
+
+        if (verbose) {
+            cout << "Sequence:";
+            for (auto n : seq) {
+                cout << ' ' << n;
+            }
+            cout << '\n';
+        }
+
+        if (both) {
+            int64_t prior, next;
+            if (!pyramid.extrapolate(seq, prior, next)) {
+                cerr << "Error: Cannot extrapolate sequence (empty or overflow).\n";
+                return 1;
+            }
+
+            if (verbose)
+                cout << "Prior in sequence: " << prior << ", next in sequence: " << next << "\n\n";
+
+            if (results.isOpen()) {
+                results.write(prior);
+                results.separator();
+                results.write(next);
+                results.endRecord();
+            }
+
+            sum      += prior;
+            otherSum += next;
+            continue;
+        }
+
+        int64_t prior;
+        if (!priorInSeq(seq, prior)) {
+            cerr << "Error: Cannot extrapolate sequence (empty, too long, or overflow).\n";
+            return 1;
+        }
+
+        if (verbose)
+            cout << "Prior in sequence: " << prior << "\n\n";
+
+        if (results.isOpen()) {
+            results.write(prior);
+            results.endRecord();
         }
-        cout << '\n';
 
-        const auto prior = priorInSeq(seq);
-        cout << "Prior in sequence: " << prior << "\n\n";
         sum += prior;
     }
 
+    if (both)
+        cout << "Next sum: " << otherSum << '\n';
+
     cout << sum << '\n';
     return 0;
 }
+
+}  // namespace puzzle09b
+
+
+AOC_PUZZLE_MAIN(09b)
@@ -126,12 +126,27 @@
 //
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
-#include <vector>
+#include <string_view>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "input.h"
+#include "puzzle.h"
 
 using namespace std;
 
+namespace puzzle10a {
+
+AOC_PUZZLE_STREAMS
+
 
 using Pipe = uint8_t;
 const Pipe PipeUp    = 0x01;
@@ -140,50 +155,91 @@ const Pipe PipeLeft  = 0x04;
 const Pipe PipeRight = 0x08;
 const Pipe PipeStart = 0x80;
 
+const Pipe PipeDirections = 0x0f;
+
+
+const struct {
+    char c;
+    Pipe pipe;
+} pipeChars[] {
+    { '|', PipeUp   | PipeDown },
+    { '-', PipeLeft | PipeRight },
+    { 'L', PipeUp   | PipeRight },
+    { 'J', PipeUp   | PipeLeft },
+    { '7', PipeDown | PipeLeft },
+    { 'F', PipeDown | PipeRight },
+    { 'S', PipeStart },
+};
+
 
-Pipe getPipeFromChar(char c) {
-    switch (c) {
-        case '|': return PipeUp   | PipeDown;
-        case '-': return PipeLeft | PipeRight;
-        case 'L': return PipeUp   | PipeRight;
-        case 'J': return PipeUp   | PipeLeft;
-        case '7': return PipeDown | PipeLeft;
-        case 'F': return PipeDown | PipeRight;
-        case 'S': return PipeStart;
+// Translation from map characters to pipes. Every other character maps to zero (no pipe).
+const auto pipeTable = [] {
+    array<Pipe, 256> table {};
+    for (const auto& entry : pipeChars)
+        table[static_cast<uint8_t>(entry.c)] = entry.pipe;
+    return table;
+}();
+
+
+void translateRow(const char* text, Pipe* pipes, int count) {
+    // Translates a run of map characters into pipes. With SSE2, sixteen characters are translated at a time by
+    // comparing against each pipe character and merging the matching pipe values. The remainder goes through the
+    // translation table.
+
+    int x = 0;
+
+#if defined(__SSE2__)
+    for (;  x + 16 <= count;  x += 16) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + x));
+        __m128i result = _mm_setzero_si128();
+        for (const auto& entry : pipeChars) {
+            const __m128i match = _mm_cmpeq_epi8(chars, _mm_set1_epi8(entry.c));
+            result = _mm_or_si128(result, _mm_and_si128(match, _mm_set1_epi8(static_cast<char>(entry.pipe))));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pipes + x), result);
     }
+#endif
 
-    return 0;
+    for (;  x < count;  ++x)
+        pipes[x] = pipeTable[static_cast<uint8_t>(text[x])];
 }
 
+
 class PipeMap {
   public: 
-    PipeMap (const vector<string>& mapText) {
-        width = mapText[0].size();
-        height = mapText.size();
+    PipeMap (const char* text, size_t size) {
+        // Builds the map directly from the raw input text. Lines must all be the same width, and each is terminated
+        // by '\n' (optionally preceded by '\r'), except perhaps the last. The map is surrounded by a border of empty
+        // tiles, so a loop tracer that follows a pipe off the edge stops there instead of leaving the map.
 
-        pipes = make_unique<Pipe[]>(width * height);
+        const char* firstLineEnd = static_cast<const char*>(memchr(text, '\n', size));
+        const size_t lineLength = firstLineEnd ? firstLineEnd - text : size;
+        const size_t stride = lineLength + 1;
 
-        // Copy map data into buffer.
+        width = (lineLength > 0 && text[lineLength-1] == '\r') ? lineLength - 1 : lineLength;
+        height = size / stride;
+        if (size % stride >= size_t(width) && width > 0)
+            ++height;   // Final line without a line terminator.
 
-        for (int y = 0; y < height; ++y) {
-            const string& line = mapText[y];
-            for (int x = 0; x < width; ++x) {
-                auto p = getPipeFromChar(line[x]);
-                if (p == PipeStart) {
-                    startX = x;
-                    startY = y;
-                }
-                (*this)(x, y) = p;
-            }
-        }
+        paddedWidth = width + 2;
+        pipes = make_unique<Pipe[]>(size_t(paddedWidth) * (height + 2));
+
+        // Translate the map a row at a time.
+
+        for (int y = 0; y < height; ++y)
+            translateRow(text + y*stride, &(*this)(0, y), width);
+
+        const char* start = static_cast<const char*>(memchr(text, 'S', size));
+        startX = start ? (start - text) % stride : 0;
+        startY = start ? (start - text) / stride : 0;
     }
 
     Pipe& operator()(int x, int y) {
-        return pipes[y*width + x];
+        return pipes[long(y+1) * paddedWidth + (x+1)];
     }
 
     const Pipe& operator()(int x, int y) const {
-        return pipes[y*width + x];
+        return pipes[long(y+1) * paddedWidth + (x+1)];
     }
 
     void dump() const {
@@ -207,8 +263,14 @@ class PipeMap {
         }
     }
 
+    // The tile at (0,0). Rows are `paddedWidth` tiles apart, and the border is one tile wide on every side.
+    const Pipe* data() const {
+        return &(*this)(0, 0);
+    }
+
     int width;
     int height;
+    int paddedWidth;
     int startX;
     int startY;
 
@@ -217,117 +279,147 @@ class PipeMap {
 };
 
 
-class Runner {
-  public:
-    Runner() : x(0), y(0), distance(0), direction(PipeStart) {}
+enum Heading : uint8_t { HeadUp, HeadDown, HeadLeft, HeadRight, HeadNowhere };
 
-    void Reset(int x, int y, Pipe direction) {
-        this->x = x;
-        this->y = y;
-        this->distance = 0;
-        this->direction = direction;
-    }
 
-    void Advance(PipeMap& pipeMap) {
-        switch (direction) {
-            case PipeUp:
-                --y;
-                direction = pipeMap(x,y) & ~PipeDown;
-                break;
-            case PipeDown:
-                ++y;
-                direction = pipeMap(x,y) & ~PipeUp;
-                break;
-            case PipeLeft:
-                --x;
-                direction = pipeMap(x,y) & ~PipeRight;
-                break;
-            case PipeRight:
-                ++x;
-                direction = pipeMap(x,y) & ~PipeLeft;
-                break;
+// Given the current heading and the pipe of the tile just entered, yields the heading on the way out of that tile.
+// Pipes that don't connect back to the tile we came from (including the start tile) yield HeadNowhere.
+const auto turnTable = [] {
+    const Pipe exitSide[4]  { PipeUp,   PipeDown, PipeLeft,  PipeRight };
+    const Pipe entrySide[4] { PipeDown, PipeUp,   PipeRight, PipeLeft  };
+
+    array<array<Heading, 16>, 4> table;
+
+    for (int heading = 0;  heading < 4;  ++heading) {
+        for (int pipe = 0;  pipe < 16;  ++pipe) {
+            table[heading][pipe] = HeadNowhere;
+            if (!(pipe & entrySide[heading]))
+                continue;
+            const Pipe exit = pipe & ~entrySide[heading];
+            for (int out = 0;  out < 4;  ++out) {
+                if (exit == exitSide[out])
+                    table[heading][pipe] = Heading(out);
+            }
         }
-        ++distance;
     }
 
-    int  x;
-    int  y;
-    int  distance;
-    Pipe direction;
+    return table;
+}();
+
+
+class LoopTracer {
+    // Traces the loop over linear tile indices. Each step is a table lookup for the tile offset and another for the
+    // new heading, with no branching on direction. Stepping off the map lands on the empty border, which yields
+    // HeadNowhere.
+
+  public:
+    LoopTracer(const PipeMap& pipeMap)
+      : pipes(pipeMap.data()),
+        start(long(pipeMap.startY) * pipeMap.paddedWidth + pipeMap.startX),
+        delta { -long(pipeMap.paddedWidth), long(pipeMap.paddedWidth), -1, 1, 0 }
+    {}
+
+    void step(long& index, Heading& heading) const {
+        index += delta[heading];
+        heading = turnTable[heading][pipes[index] & PipeDirections];
+    }
+
+    const Pipe* pipes;
+    const long  start;
+
+  private:
+    const long delta[5];
 };
 
 
-int maxDistanceFromStart(PipeMap& pipeMap) {
-    bool haveRunner1 = false;
+int startHeadings(const PipeMap& pipeMap, Heading headings[4]) {
+    // Fills in the headings that lead from the start tile into connecting pipes, and returns how many there are.
 
-    Runner runner1, runner2;
-    int startX = pipeMap.startX;
-    int startY = pipeMap.startY;
-    int width = pipeMap.width;
-    int height = pipeMap.height;
-    Pipe pipe {0};
+    const int x = pipeMap.startX;
+    const int y = pipeMap.startY;
+    int count = 0;
 
-    if (startY > 0 && (pipeMap(startX, startY-1) & PipeDown)) {
-        runner1.Reset(startX, startY, PipeUp);
-        haveRunner1 = true;
-    }
+    if (y > 0 && (pipeMap(x, y-1) & PipeDown))
+        headings[count++] = HeadUp;
+    if (y < pipeMap.height-1 && (pipeMap(x, y+1) & PipeUp))
+        headings[count++] = HeadDown;
+    if (x > 0 && (pipeMap(x-1, y) & PipeRight))
+        headings[count++] = HeadLeft;
+    if (x < pipeMap.width-1 && (pipeMap(x+1, y) & PipeLeft))
+        headings[count++] = HeadRight;
 
-    if (startY < pipeMap.height && (pipeMap(startX, startY+1) & PipeUp)) {
-        if (haveRunner1) {
-            runner2.Reset(startX, startY, PipeDown);
-        } else {
-            runner1.Reset(startX, startY, PipeDown);
-            haveRunner1 = true;
-        }
-    }
+    return count;
+}
 
-    if (startX > 0 && (pipeMap(startX-1, startY) & PipeRight)) {
-        if (haveRunner1) {
-            runner2.Reset(startX, startY, PipeLeft);
-        } else {
-            runner1.Reset(startX, startY, PipeLeft);
-            haveRunner1 = true;
-        }
-    }
 
-    if (startX < height && (pipeMap(startX+1, startY) & PipeLeft)) {
-        if (haveRunner1) {
-            runner2.Reset(startX, startY, PipeRight);
-        } else {
-            runner1.Reset(startX, startY, PipeRight);
-            haveRunner1 = true;
-        }
-    }
+int maxDistanceFromStart(const PipeMap& pipeMap, bool oneWay) {
+    // Returns the distance to the farthest point of the loop, or -1 if the loop is broken. By default, two tracers set
+    // off in opposite directions from the start and stop when they meet. Since any loop on a grid has even length, they
+    // meet on the same tile. With oneWay, a single tracer goes all the way around, and the answer is half the loop.
 
-    while (true) {
-        runner1.Advance(pipeMap);
-        if (runner1.x == runner2.x && runner1.y == runner2.y)
-            break;
-        runner2.Advance(pipeMap);
-        if (runner1.x == runner2.x && runner1.y == runner2.y)
-            break;
+    const LoopTracer tracer(pipeMap);
+
+    Heading headings[4];
+    if (startHeadings(pipeMap, headings) < 2)
+        return -1;
+
+    if (oneWay) {
+        long    index = tracer.start;
+        Heading heading = headings[0];
+        int     length = 0;
+
+        do {
+            tracer.step(index, heading);
+            ++length;
+        } while (heading != HeadNowhere);
+
+        return (index == tracer.start) ? length / 2 : -1;
     }
 
-    return runner1.distance;
-}
+    long    index1 = tracer.start,  index2 = tracer.start;
+    Heading heading1 = headings[0], heading2 = headings[1];
+    int     distance = 0;
 
-int main() {
-    vector<string> mapText;
-    string line;
+    do {
+        tracer.step(index1, heading1);
+        tracer.step(index2, heading2);
+        ++distance;
+    } while (index1 != index2 && heading1 != HeadNowhere && heading2 != HeadNowhere);
 
-    while (getline(cin, line))
-        mapText.push_back(line);
+    return (index1 == index2) ? distance : -1;
+}
 
-    // for (auto& line : mapText)
-    //     cout << '(' << line << ")\n";
 
-    // cout << '\n';
+int solve(int argc, char* argv[]) {
+    bool oneWay = false;   // Set with `--one-way` to trace the whole loop in a single direction.
 
-    PipeMap pipeMap(mapText);
+    for (int i = 1;  i < argc;  ++i) {
+        string_view arg {argv[i]};
+        if (arg == "--one-way")
+            oneWay = true;
+        else {
+            cerr << "Error: Unrecognized option '" << arg << "'.\n";
+            return 1;
+        }
+    }
+
+    aoc::Input input;
+    PipeMap pipeMap(input.data(), input.size());
 
     // pipeMap.dump();
 
-    cout << "Maximum distance from start: " << maxDistanceFromStart(pipeMap) << '\n';
+    const int maxDistance = maxDistanceFromStart(pipeMap, oneWay);
+    if (maxDistance < 0) {
+        cerr << "Error: The loop from the start tile is broken.\n";
+        return 1;
+    }
+
+    cout << "Maximum distance from start: " << maxDistance << '\n';
 
     return 0;
 }
+
+}  // namespace puzzle10a
+
+
+AOC_PUZZLE_MAIN(10a)
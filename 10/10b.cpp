@@ -232,12 +232,35 @@
 // enclosed by the loop?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <numeric>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "input.h"
+#include "puzzle.h"
+
 using namespace std;
 
+namespace puzzle10b {
+
+AOC_PUZZLE_STREAMS
+
 
 const bool verbose = false;
 
@@ -262,41 +285,111 @@ const Pipe PipeDownLeft   = PipeDown | PipeLeft;
 const Pipe PipeMatchingCorners = PipeUp | PipeDown | PipeLeft | PipeRight;
 
 
-Pipe getPipeFromChar(char c) {
-    switch (c) {
-        case '|': return PipeVertical;
-        case '-': return PipeHorizontal;
-        case 'L': return PipeUpRight;
-        case 'J': return PipeUpLeft;
-        case '7': return PipeDownLeft;
-        case 'F': return PipeDownRight;
-        case 'S': return PipeStart;
+const struct {
+    char c;
+    Pipe pipe;
+} pipeChars[] {
+    { '|', PipeVertical },
+    { '-', PipeHorizontal },
+    { 'L', PipeUpRight },
+    { 'J', PipeUpLeft },
+    { '7', PipeDownLeft },
+    { 'F', PipeDownRight },
+    { 'S', PipeStart },
+};
+
+
+// Translation from map characters to pipes. Every other character maps to zero (no pipe).
+const auto pipeTable = [] {
+    array<Pipe, 256> table {};
+    for (const auto& entry : pipeChars)
+        table[static_cast<uint8_t>(entry.c)] = entry.pipe;
+    return table;
+}();
+
+
+void translateRow(const char* text, Pipe* pipes, int count) {
+    // Translates a run of map characters into pipes. With SSE2, sixteen characters are translated at a time by
+    // comparing against each pipe character and merging the matching pipe values. The remainder goes through the
+    // translation table.
+
+    int x = 0;
+
+#if defined(__SSE2__)
+    for (;  x + 16 <= count;  x += 16) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + x));
+        __m128i result = _mm_setzero_si128();
+        for (const auto& entry : pipeChars) {
+            const __m128i match = _mm_cmpeq_epi8(chars, _mm_set1_epi8(entry.c));
+            result = _mm_or_si128(result, _mm_and_si128(match, _mm_set1_epi8(static_cast<char>(entry.pipe))));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pipes + x), result);
     }
+#endif
 
-    return 0;
+    for (;  x < count;  ++x)
+        pipes[x] = pipeTable[static_cast<uint8_t>(text[x])];
 }
 
+
+template <typename RowFunction>
+void forEachRow(int height, unsigned numThreads, RowFunction rowFunction) {
+    // Calls rowFunction(y) for every row. With more than one thread, bands of rows are handed out to worker threads as
+    // they become free, so rows must be independent of each other.
+
+    if (numThreads <= 1) {
+        for (int y = 0;  y < height;  ++y)
+            rowFunction(y);
+        return;
+    }
+
+    const int   bandSize = 16;
+    atomic<int> nextRow {0};
+
+    auto worker = [&]() {
+        for (int start;  (start = nextRow.fetch_add(bandSize)) < height; ) {
+            const int end = min(start + bandSize, height);
+            for (int y = start;  y < end;  ++y)
+                rowFunction(y);
+        }
+    };
+
+    vector<thread> threads;
+    for (unsigned i = 1;  i < numThreads;  ++i)
+        threads.emplace_back(worker);
+    worker();
+
+    for (auto& t : threads)
+        t.join();
+}
+
+
 class PipeMap {
   public:
-    PipeMap (const vector<string>& mapText) {
-        width = mapText[0].size();
-        height = mapText.size();
+    PipeMap (const char* text, size_t size, unsigned numThreads = 1) {
+        // Builds the map directly from the raw input text. Lines must all be the same width, and each is terminated
+        // by '\n' (optionally preceded by '\r'), except perhaps the last.
+
+        const char* firstLineEnd = static_cast<const char*>(memchr(text, '\n', size));
+        const size_t lineLength = firstLineEnd ? firstLineEnd - text : size;
+        const size_t stride = lineLength + 1;
+
+        width = (lineLength > 0 && text[lineLength-1] == '\r') ? lineLength - 1 : lineLength;
+        height = size / stride;
+        if (size % stride >= size_t(width) && width > 0)
+            ++height;   // Final line without a line terminator.
 
         pipes = make_unique<Pipe[]>(width * height);
 
-        // Copy map data into buffer.
+        // Translate the map a row at a time.
 
-        for (int y = 0; y < height; ++y) {
-            const string& line = mapText[y];
-            for (int x = 0; x < width; ++x) {
-                auto p = getPipeFromChar(line[x]);
-                if (p == PipeStart) {
-                    startX = x;
-                    startY = y;
-                }
-                (*this)(x, y) = p;
-            }
-        }
+        forEachRow(height, numThreads, [&](int y) {
+            translateRow(text + y*stride, pipes.get() + y*width, width);
+        });
+
+        const char* start = static_cast<const char*>(memchr(text, 'S', size));
+        startX = start ? (start - text) % stride : 0;
+        startY = start ? (start - text) / stride : 0;
 
         deduceStartShape();
     }
@@ -421,20 +514,23 @@ void markLoop(PipeMap& pipeMap) {
 }
 
 
-void removeJunk(PipeMap& pipeMap) {
-    for (auto y=0;  y < pipeMap.height;  ++y) {
+void removeJunk(PipeMap& pipeMap, unsigned numThreads = 1) {
+    forEachRow(pipeMap.height, numThreads, [&](int y) {
         for (auto x=0;  x < pipeMap.width;  ++x) {
             const auto pipe = pipeMap(x,y);
             if ((pipe & PipeLoop) == 0)
                 pipeMap(x,y) = 0;
         }
-    }
+    });
 }
 
-int markInside(PipeMap& pipeMap) {
-    int insideArea = 0;
+int markInside(PipeMap& pipeMap, unsigned numThreads = 1) {
+    // Each row is scanned independently, so rows are spread across threads and their areas summed at the end.
+
+    vector<int> rowAreas(pipeMap.height, 0);
 
-    for (int y=0;  y < pipeMap.height;  ++y) {
+    forEachRow(pipeMap.height, numThreads, [&](int y) {
+        int& insideArea = rowAreas[y];
 
         bool inside = false;
         bool inHorizontalEdge = false;
@@ -468,25 +564,194 @@ int markInside(PipeMap& pipeMap) {
                 horizontalEdgeCornerStart = pipe;
             }
         }
+    });
+
+    return accumulate(rowAreas.begin(), rowAreas.end(), 0);
+}
+
+
+long shoelaceInsideArea(PipeMap& pipeMap) {
+    // Alternative to markLoop(), removeJunk() and markInside(). This walks the loop once, accumulating twice its signed
+    // area with the shoelace formula. Since the loop tile centers are lattice points, Pick's theorem (A = I + B/2 - 1)
+    // then yields the number of interior tiles I from the area A and the number of boundary tiles B, without any
+    // passes over the rest of the grid.
+
+    const int startX = pipeMap.startX;
+    const int startY = pipeMap.startY;
+
+    // Head off in any direction the start pipe leads.
+    const Pipe startShape = pipeMap(startX, startY) & PipeDirections;
+    if (startShape == 0)
+        return 0;
+
+    Runner runner;
+    runner.Reset(startX, startY, startShape & -startShape);
+
+    long twiceArea = 0;
+
+    do {
+        const long priorX = runner.x;
+        const long priorY = runner.y;
+        runner.Advance(pipeMap);
+        twiceArea += priorX * runner.y - runner.x * priorY;
+    } while (runner.x != startX || runner.y != startY);
+
+    const long boundary = runner.distance;
+
+    return (labs(twiceArea) - boundary) / 2 + 1;
+}
+
+
+class LoopBitPlanes {
+    // An alternative layout for inside marking. Rather than a byte per tile, each row holds two bitsets: one marking
+    // loop tiles, and one marking loop tiles that connect upward (|, L and J). Scanning a row from the left, a tile is
+    // inside the loop exactly when it's not on the loop and an odd number of upward-connecting tiles lie before it. That
+    // parity is a prefix XOR of the crossing bits, so each row is processed 64 tiles at a time.
+
+  public:
+    LoopBitPlanes(int width, int height)
+      : width(width), height(height), wordsPerRow((width + 63) / 64),
+        loop(size_t(wordsPerRow) * height, 0), crossing(size_t(wordsPerRow) * height, 0)
+    {}
+
+    void set(int x, int y, Pipe pipe) {
+        const size_t   index = size_t(y) * wordsPerRow + x / 64;
+        const uint64_t bit = uint64_t(1) << (x % 64);
+
+        loop[index] |= bit;
+        if (pipe & PipeUp)
+            crossing[index] |= bit;
+    }
+
+    long countInside(unsigned numThreads = 1) const {
+        vector<long> rowAreas(height, 0);
+        forEachRow(height, numThreads, [&](int y) { rowAreas[y] = countInsideRow(y); });
+        return accumulate(rowAreas.begin(), rowAreas.end(), 0L);
+    }
+
+    long countInsideRow(int y) const {
+        const uint64_t* loopRow     = loop.data()     + size_t(y) * wordsPerRow;
+        const uint64_t* crossingRow = crossing.data() + size_t(y) * wordsPerRow;
+
+        uint64_t parity = 0;   // All ones when inside at the start of the current word.
+        long     count = 0;
+
+        for (int w = 0;  w < wordsPerRow;  ++w) {
+            uint64_t inside = crossingRow[w];
+            inside ^= inside << 1;
+            inside ^= inside << 2;
+            inside ^= inside << 4;
+            inside ^= inside << 8;
+            inside ^= inside << 16;
+            inside ^= inside << 32;
+            inside ^= parity;
+
+            parity = (inside >> 63) ? ~uint64_t(0) : 0;
+
+            uint64_t mask = ~loopRow[w];
+            if (w == wordsPerRow - 1 && width % 64 != 0)
+                mask &= (uint64_t(1) << (width % 64)) - 1;
+
+            count += popcount(inside & mask);
+        }
+
+        return count;
     }
 
-    return insideArea;
+  private:
+    int width;
+    int height;
+    int wordsPerRow;
+
+    vector<uint64_t> loop;
+    vector<uint64_t> crossing;
+};
+
+
+LoopBitPlanes traceLoopBitPlanes(PipeMap& pipeMap) {
+    // Walks the loop once, recording each loop tile in a new set of bit planes.
+
+    LoopBitPlanes planes(pipeMap.width, pipeMap.height);
+
+    const int  startX = pipeMap.startX;
+    const int  startY = pipeMap.startY;
+    const Pipe startShape = pipeMap(startX, startY) & PipeDirections;
+
+    if (startShape == 0)
+        return planes;
+
+    Runner runner;
+    runner.Reset(startX, startY, startShape & -startShape);
+
+    do {
+        planes.set(runner.x, runner.y, pipeMap(runner.x, runner.y));
+        runner.Advance(pipeMap);
+    } while (runner.x != startX || runner.y != startY);
+
+    return planes;
 }
 
 
-int main() {
-    vector<string> mapText;
-    string line;
+bool parseThreadCount(string_view digits, unsigned& count) {
+    // Parses a decimal thread count. Returns false if the string is empty, contains a non-digit, or overflows.
+
+    if (digits.empty())
+        return false;
+
+    count = 0;
+    for (auto c : digits) {
+        if (c < '0' || '9' < c)
+            return false;
+        const unsigned digit = c - '0';
+        if (count > (UINT_MAX - digit) / 10)
+            return false;
+        count = 10*count + digit;
+    }
+    return true;
+}
+
 
-    while (getline(cin, line))
-        mapText.push_back(line);
+int solve(int argc, char* argv[]) {
+    bool useShoelace  = false;   // Set with `--shoelace` to use shoelaceInsideArea().
+    bool useBitPlanes = false;   // Set with `--bitplanes` to count inside tiles with LoopBitPlanes.
+    unsigned numThreads = 1;     // Set with `--threads <n>` (0 for all hardware threads) to process rows in parallel.
+
+    for (int i = 1;  i < argc;  ++i) {
+        string_view arg {argv[i]};
+        if (arg == "--shoelace")
+            useShoelace = true;
+        else if (arg == "--bitplanes")
+            useBitPlanes = true;
+        else if (arg == "--threads" && i+1 < argc) {
+            if (!parseThreadCount(argv[++i], numThreads)) {
+                cerr << "Error: Bad value '" << argv[i] << "' for option '" << arg << "'.\n";
+                return 1;
+            }
+            if (numThreads == 0)
+                numThreads = max(1u, thread::hardware_concurrency());
+        } else {
+            cerr << "Error: Unrecognized option '" << arg << "'.\n";
+            return 1;
+        }
+    }
 
-    PipeMap pipeMap(mapText);
+    aoc::Input input;
+    PipeMap pipeMap(input.data(), input.size(), numThreads);
     if (verbose) {
         cout << "\nOn Load:\n";
         pipeMap.dump();
     }
 
+    if (useShoelace) {
+        cout << "Inside area: " << shoelaceInsideArea(pipeMap) << '\n';
+        return 0;
+    }
+
+    if (useBitPlanes) {
+        cout << "Inside area: " << traceLoopBitPlanes(pipeMap).countInside(numThreads) << '\n';
+        return 0;
+    }
+
     if (verbose) {
         cout << "\nMarking Loop:";
     }
@@ -496,13 +761,13 @@ int main() {
         pipeMap.dump();
     }
 
-    removeJunk(pipeMap);
+    removeJunk(pipeMap, numThreads);
     if (verbose) {
         cout << "\nJunk Removed:\n";
         pipeMap.dump();
     }
 
-    int insideArea = markInside(pipeMap);
+    int insideArea = markInside(pipeMap, numThreads);
     if (verbose) {
         cout << "\nInside Marked:\n";
         pipeMap.dump();
@@ -513,3 +778,8 @@ int main() {
 
     return 0;
 }
+
+}  // namespace puzzle10b
+
+
+AOC_PUZZLE_MAIN(10b)
@@ -111,12 +111,24 @@
 //
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <bit>
+#include <cstdint>
 #include <iostream>
-#include <string>
 #include <vector>
 
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "input.h"
+#include "puzzle.h"
+
 using namespace std;
 
+namespace puzzle11a {
+
+AOC_PUZZLE_STREAMS
+
 bool verbose = false;
 
 class Galaxy {
@@ -129,61 +141,148 @@ class Galaxy {
 };
 
 
-int main() {
-    
-    // Read in all lines from input.
-
-    string line;
-    vector<string> lines;
-    int width = 0;
-    while (getline(cin, line)) {
-
-        if (width == 0)
-            width = line.size();
-        else {
-            if (line.size() != width) {
-                cerr << "Error: line width mismatch\n";
-                return 1;
+class GalaxyScanner {
+    // Extracts galaxies from the image as it streams by in blocks, without keeping the image itself. With SSE2, each
+    // 16-byte chunk is compared against '#' and '\n' at once, and only the matching positions are visited. The scanner
+    // records the galaxies and the number of galaxies in each column and row (zero marking an empty one).
+
+  public:
+    bool scan(const char* block, size_t size) {
+        // Scans the next block of the image. Returns false if a line's width doesn't match the first line.
+
+        size_t i = 0;
+
+#if defined(__SSE2__)
+        const __m128i hash    = _mm_set1_epi8('#');
+        const __m128i newline = _mm_set1_epi8('\n');
+
+        for (;  i + 16 <= size;  i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            unsigned matches = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, hash), _mm_cmpeq_epi8(chunk, newline)));
+            for (;  matches;  matches &= matches - 1) {
+                if (!visit(block, i + countr_zero(matches)))
+                    return false;
             }
         }
+#endif
 
-        lines.push_back(line);
-    }
-    int height = lines.size();
+        for (;  i < size;  ++i) {
+            if ((block[i] == '#' || block[i] == '\n') && !visit(block, i))
+                return false;
+        }
 
-    // Initialize the horizontal sizes array.
+        if (size > 0)
+            lastByte = block[size - 1];
+        offset += size;
 
-    vector<int> sizesX;
-    sizesX.resize(width);
-    for (int i = 0;  i < width;  ++i)
-        sizesX[i] = 2;
+        return true;
+    }
 
-    // Initialize the vertical sizes array.
+    bool finish() {
+        // Ends the scan, accounting for a final line without a line terminator.
 
-    vector<int>  sizesY;
-    sizesY.resize(height);
+        if (lineStart < offset && !endLine(offset, lastByte))
+            return false;
 
-    // Grab all galaxies from the field into a list. At the same time, set the elements of the
-    // sizesX and sizesY arrays.
+        countsX.resize(width, 0);
+        return true;
+    }
 
-    int galaxySN = 0;
+    int width {0};
+    int height {0};
     vector<Galaxy> galaxies;
-    for (int j = 0;  j < height;  ++j) {
-        auto& line = lines[j];
-        if (verbose) cout << '(' << line << ")\n";
+    vector<int> countsX;
+    vector<int> countsY;
+
+  private:
+    bool visit(const char* block, size_t i) {
+        if (block[i] == '\n')
+            return endLine(offset + i, (i > 0) ? block[i-1] : lastByte);
+
+        const int x = offset + i - lineStart;
+        galaxies.push_back(Galaxy(galaxies.size(), x, height));
+        if (countsX.size() <= size_t(x))
+            countsX.resize(x + 1, 0);
+        ++countsX[x];
+        ++rowCount;
+        return true;
+    }
+
+    bool endLine(uint64_t end, char previous) {
+        int lineWidth = end - lineStart;
+        if (lineWidth > 0 && previous == '\r')
+            --lineWidth;
+
+        if (height == 0)
+            width = lineWidth;
+        else if (lineWidth != width)
+            return false;
+
+        countsY.push_back(rowCount);
+        rowCount = 0;
+        ++height;
+        lineStart = end + 1;
+        return true;
+    }
+
+    uint64_t offset {0};      // Stream offset of the current block.
+    uint64_t lineStart {0};   // Stream offset of the current line.
+    char     lastByte {0};    // Final byte of the previous block.
+    int      rowCount {0};    // Galaxies found so far in the current line.
+};
 
-        size_t i = 0;
-        bool galaxyInLine = false;
-        while (string::npos != (i = line.find('#', i))) {
-            galaxies.push_back(Galaxy(galaxySN++, i, j));
-            sizesX[i] = 1;
-            galaxyInLine = true;
-            ++i;
-        }
 
-        sizesY[j] = galaxyInLine ? 1 : 2;
+long sumAxisDistances(const vector<int>& counts, const vector<int>& positions) {
+    // Returns the sum of the distances along one axis between every pair of galaxies. Galaxies are bucketed by column
+    // (or row), which sorts them by expanded position, since positions increase with the index. Each bucket then
+    // contributes count × (earlierCount × position − earlierPositionSum) against all galaxies before it, so the whole
+    // sum takes one linear pass.
+
+    long sum = 0;
+    long earlierCount = 0;
+    long earlierPositionSum = 0;
+
+    for (size_t i = 0;  i < counts.size();  ++i) {
+        if (counts[i] == 0)
+            continue;
+        sum += counts[i] * (earlierCount * positions[i] - earlierPositionSum);
+        earlierCount += counts[i];
+        earlierPositionSum += long(counts[i]) * positions[i];
     }
 
+    return sum;
+}
+
+
+int solve(int argc, char* argv[]) {
+    
+    // Scan the image, extracting galaxies as we go. Piped input is streamed in a block at a time.
+
+    GalaxyScanner scanner;
+    auto scanBlock = [&](string_view block) { return scanner.scan(block.data(), block.size()); };
+
+    if (!aoc::Input::scanBlocks(1 << 20, scanBlock) || !scanner.finish()) {
+        cerr << "Error: line width mismatch\n";
+        return 1;
+    }
+
+    const int width  = scanner.width;
+    const int height = scanner.height;
+    const vector<Galaxy>& galaxies = scanner.galaxies;
+    const vector<int>& countsX = scanner.countsX;
+    const vector<int>& countsY = scanner.countsY;
+
+    // Empty columns and rows expand to twice their size.
+
+    vector<int> sizesX(width);
+    for (int i = 0;  i < width;  ++i)
+        sizesX[i] = countsX[i] ? 1 : 2;
+
+    vector<int> sizesY(height);
+    for (int j = 0;  j < height;  ++j)
+        sizesY[j] = countsY[j] ? 1 : 2;
+
+
     // Using the sizesX array, calculate the distancesX array.
 
     if (verbose) cout << "\nSizesX: ";
@@ -217,26 +316,23 @@ int main() {
     }
     if (verbose) cout << "\n\n";
 
-    // Calculate the sum of the distances between all pairs of galaxies.
-
-    long sumDistances = 0;
+    // Calculate the sum of the distances between all pairs of galaxies. Manhattan distances separate by axis.
 
-    for (int i = 0;  i < galaxies.size();  ++i) {
-        auto& galaxy = galaxies[i];
-        if (verbose) cout << "Galaxy " << (galaxy.sn+1) << " at (" << galaxy.x << ", " << galaxy.y << ")\n";
-        for (int j = i+1;  j < galaxies.size();  ++j) {
-            auto& otherGalaxy = galaxies[j];
-            int dx = abs(distancesX[galaxy.x] - distancesX[otherGalaxy.x]);
-            int dy = abs(distancesY[galaxy.y] - distancesY[otherGalaxy.y]);
-            int distance = dx + dy;
-            sumDistances += distance;
-            if (verbose) cout << "  Distance to " << (otherGalaxy.sn+1) << " is " << distance << '\n';
-        }
+    if (verbose) {
+        for (const auto& galaxy : galaxies)
+            cout << "Galaxy " << (galaxy.sn+1) << " at (" << galaxy.x << ", " << galaxy.y << ")\n";
     }
 
+    long sumDistances = sumAxisDistances(countsX, distancesX) + sumAxisDistances(countsY, distancesY);
+
     // Report the result.
 
     cout << "Total distances: " << sumDistances << '\n';
 
     return 0;
 }
+
+}  // namespace puzzle11a
+
+
+AOC_PUZZLE_MAIN(11a)
@@ -126,12 +126,29 @@
 // shortest path between every pair of galaxies. What is the sum of these lengths?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <bit>
+#include <charconv>
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "input.h"
+#include "puzzle.h"
+
 using namespace std;
 
+namespace puzzle11b {
+
+AOC_PUZZLE_STREAMS
+
+using uint128 = unsigned __int128;
+
 bool verbose = false;
 const int expansionFactor = 1000000;
 
@@ -145,120 +162,233 @@ class Galaxy {
 };
 
 
-int main() {
-    
-    // Read in all lines from input.
+class GalaxyScanner {
+    // Extracts galaxies from the image as it streams by in blocks, without keeping the image itself. With SSE2, each
+    // 16-byte chunk is compared against '#' and '\n' at once, and only the matching positions are visited. The scanner
+    // records the galaxies and the number of galaxies in each column and row (zero marking an empty one).
+
+  public:
+    bool scan(const char* block, size_t size) {
+        // Scans the next block of the image. Returns false if a line's width doesn't match the first line.
 
-    string line;
-    vector<string> lines;
-    int width = 0;
-    while (getline(cin, line)) {
+        size_t i = 0;
 
-        if (width == 0)
-            width = line.size();
-        else {
-            if (line.size() != width) {
-                cerr << "Error: line width mismatch\n";
-                return 1;
+#if defined(__SSE2__)
+        const __m128i hash    = _mm_set1_epi8('#');
+        const __m128i newline = _mm_set1_epi8('\n');
+
+        for (;  i + 16 <= size;  i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            unsigned matches = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, hash), _mm_cmpeq_epi8(chunk, newline)));
+            for (;  matches;  matches &= matches - 1) {
+                if (!visit(block, i + countr_zero(matches)))
+                    return false;
             }
         }
+#endif
 
-        lines.push_back(line);
-    }
-    int height = lines.size();
+        for (;  i < size;  ++i) {
+            if ((block[i] == '#' || block[i] == '\n') && !visit(block, i))
+                return false;
+        }
 
-    // Initialize the horizontal sizes array.
+        if (size > 0)
+            lastByte = block[size - 1];
+        offset += size;
 
-    vector<uint64_t> sizesX;
-    sizesX.resize(width);
-    for (int i = 0;  i < width;  ++i)
-        sizesX[i] = expansionFactor;
+        return true;
+    }
 
-    // Initialize the vertical sizes array.
+    bool finish() {
+        // Ends the scan, accounting for a final line without a line terminator.
 
-    vector<uint64_t> sizesY;
-    sizesY.resize(height);
+        if (lineStart < offset && !endLine(offset, lastByte))
+            return false;
 
-    // Grab all galaxies from the field into a list. At the same time, set the elements of the
-    // sizesX and sizesY arrays.
+        countsX.resize(width, 0);
+        return true;
+    }
 
-    int galaxySN = 0;
+    int width {0};
+    int height {0};
     vector<Galaxy> galaxies;
-    for (int j = 0;  j < height;  ++j) {
-        auto& line = lines[j];
-        if (verbose) cout << '(' << line << ")\n";
-
-        size_t i = 0;
-        bool galaxyInLine = false;
-        while (string::npos != (i = line.find('#', i))) {
-            galaxies.push_back(Galaxy(galaxySN++, i, j));
-            sizesX[i] = 1;
-            galaxyInLine = true;
-            ++i;
-        }
+    vector<uint64_t> countsX;
+    vector<uint64_t> countsY;
+
+  private:
+    bool visit(const char* block, size_t i) {
+        if (block[i] == '\n')
+            return endLine(offset + i, (i > 0) ? block[i-1] : lastByte);
+
+        const int x = offset + i - lineStart;
+        galaxies.push_back(Galaxy(galaxies.size(), x, height));
+        if (countsX.size() <= size_t(x))
+            countsX.resize(x + 1, 0);
+        ++countsX[x];
+        ++rowCount;
+        return true;
+    }
 
-        sizesY[j] = galaxyInLine ? 1 : expansionFactor;
+    bool endLine(uint64_t end, char previous) {
+        int lineWidth = end - lineStart;
+        if (lineWidth > 0 && previous == '\r')
+            --lineWidth;
+
+        if (height == 0)
+            width = lineWidth;
+        else if (lineWidth != width)
+            return false;
+
+        countsY.push_back(rowCount);
+        rowCount = 0;
+        ++height;
+        lineStart = end + 1;
+        return true;
     }
 
-    // Using the sizesX array, calculate the distancesX array.
+    uint64_t offset {0};      // Stream offset of the current block.
+    uint64_t lineStart {0};   // Stream offset of the current line.
+    char     lastByte {0};    // Final byte of the previous block.
+    uint64_t rowCount {0};    // Galaxies found so far in the current line.
+};
 
-    if (verbose) cout << "\nSizesX: ";
-    vector<uint64_t> distancesX;
-    distancesX.resize(width);
-    for (int i = 0;  i < width;  ++i) {
-        if (verbose) cout << sizesX[i];
 
-        if (i == 0)
-            distancesX[i] = 0;
-        else
-            distancesX[i] = distancesX[i-1] + sizesX[i-1];
+uint128 sumAxisDistances(const vector<uint64_t>& counts, const vector<uint64_t>& positions) {
+    // Returns the sum of the distances along one axis between every pair of galaxies. Galaxies are bucketed by column
+    // (or row), which sorts them by expanded position, since positions increase with the index. Each bucket then
+    // contributes count × (earlierCount × position − earlierPositionSum) against all galaxies before it, so the whole
+    // sum takes one linear pass.
+
+    uint128 sum = 0;
+    uint128 earlierCount = 0;
+    uint128 earlierPositionSum = 0;
 
-        if (verbose) cout << '(' << distancesX[i] << "), ";
+    for (size_t i = 0;  i < counts.size();  ++i) {
+        if (counts[i] == 0)
+            continue;
+        sum += counts[i] * (earlierCount * positions[i] - earlierPositionSum);
+        earlierCount += counts[i];
+        earlierPositionSum += uint128(counts[i]) * positions[i];
     }
 
-    // Using the sizesY array, calculate the distancesY array.
+    return sum;
+}
 
-    if (verbose) cout << "\nDeltaY: ";
-    vector<uint64_t> distancesY;
-    distancesY.resize(height);
-    for (int i = 0;  i < height;  ++i) {
-        if (verbose) cout << sizesY[i];
 
-        if (i == 0)
-            distancesY[i] = 0;
-        else
-            distancesY[i] = distancesY[i-1] + sizesY[i-1];
+bool parseFactors(string_view list, vector<uint64_t>& factors) {
+    // Parses a comma-separated list of positive expansion factors.
 
-        if (verbose) cout << '(' << distancesY[i] << "), ";
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        auto item = list.substr(0, comma);
+
+        uint64_t factor = 0;
+        auto [end, error] = from_chars(item.data(), item.data() + item.size(), factor);
+        if (error != errc{} || end != item.data() + item.size() || factor == 0)
+            return false;
+
+        factors.push_back(factor);
+        list = (comma == string_view::npos) ? string_view{} : list.substr(comma + 1);
     }
-    if (verbose) cout << "\n\n";
 
-    // Calculate the sum of the distances between all pairs of galaxies.
+    return !factors.empty();
+}
+
+
+int solve(int argc, char* argv[]) {
 
-    uint64_t sumDistances = 0;
+    // With `--factors <list>`, report the total distance for each of a comma-separated list of expansion factors.
 
-    for (int i = 0;  i < galaxies.size();  ++i) {
-        auto& galaxy = galaxies[i];
-        if (verbose) cout << "Galaxy " << (galaxy.sn+1) << " at (" << galaxy.x << ", " << galaxy.y << ")\n";
-        for (int j = i+1;  j < galaxies.size();  ++j) {
-            auto& otherGalaxy = galaxies[j];
-            uint64_t dx = labs(distancesX[otherGalaxy.x] - distancesX[galaxy.x]);
-            uint64_t dy = labs(distancesY[otherGalaxy.y] - distancesY[galaxy.y]);
-            uint64_t distance = dx + dy;
+    vector<uint64_t> factors;
 
-            if (sumDistances + distance < sumDistances) {
-                cerr << "Error: sumDistances overflow\n";
+    for (int i = 1;  i < argc;  ++i) {
+        string_view arg {argv[i]};
+        if (arg == "--factors" && i+1 < argc) {
+            if (!parseFactors(argv[++i], factors)) {
+                cerr << "Error: Bad expansion factor list '" << argv[i] << "'.\n";
                 return 1;
             }
+        } else {
+            cerr << "Error: Unrecognized option '" << arg << "'.\n";
+            return 1;
+        }
+    }
+
+    const bool reportFactors = !factors.empty();
+    if (!reportFactors)
+        factors.push_back(expansionFactor);
+
+    // Scan the image, extracting galaxies as we go. Piped input is streamed in a block at a time.
+
+    GalaxyScanner scanner;
+    auto scanBlock = [&](string_view block) { return scanner.scan(block.data(), block.size()); };
+
+    if (!aoc::Input::scanBlocks(1 << 20, scanBlock) || !scanner.finish()) {
+        cerr << "Error: line width mismatch\n";
+        return 1;
+    }
 
-            sumDistances += distance;
-            if (verbose) cout << "  Distance to " << (otherGalaxy.sn+1) << " is " << distance << '\n';
+    const vector<Galaxy>& galaxies = scanner.galaxies;
+    const vector<uint64_t>& countsX = scanner.countsX;
+    const vector<uint64_t>& countsY = scanner.countsY;
+
+
+    // For any expansion factor, the distance between two galaxies is their unexpanded distance plus (factor - 1) for
+    // each empty column or row between them. So the sum over all pairs is base + (factor - 1) × emptyCrossings, where
+    // base sums over the unexpanded positions and emptyCrossings sums over the count of empty columns or rows before
+    // each position. Both sums are taken once, and then every factor is answered from them.
+
+    auto unexpandedPositions = [](const vector<uint64_t>& counts) {
+        vector<uint64_t> positions(counts.size());
+        for (size_t i = 0;  i < counts.size();  ++i)
+            positions[i] = i;
+        return positions;
+    };
+
+    auto emptyBefore = [](const vector<uint64_t>& counts) {
+        vector<uint64_t> positions(counts.size());
+        uint64_t numEmpty = 0;
+        for (size_t i = 0;  i < counts.size();  ++i) {
+            positions[i] = numEmpty;
+            if (counts[i] == 0)
+                ++numEmpty;
         }
+        return positions;
+    };
+
+    if (verbose) {
+        for (const auto& galaxy : galaxies)
+            cout << "Galaxy " << (galaxy.sn+1) << " at (" << galaxy.x << ", " << galaxy.y << ")\n";
     }
 
-    // Report the result.
+    const uint128 base = sumAxisDistances(countsX, unexpandedPositions(countsX))
+                       + sumAxisDistances(countsY, unexpandedPositions(countsY));
+
+    const uint128 emptyCrossings = sumAxisDistances(countsX, emptyBefore(countsX))
+                                 + sumAxisDistances(countsY, emptyBefore(countsY));
+
+    // Report the results.
 
-    cout << "Total distances: " << sumDistances << '\n';
+    for (auto factor : factors) {
+        uint128 total;
+        if (__builtin_mul_overflow(uint128(factor - 1), emptyCrossings, &total)
+                || __builtin_add_overflow(total, base, &total) || total > UINT64_MAX) {
+            cerr << "Error: sumDistances overflow\n";
+            return 1;
+        }
+
+        uint64_t sumDistances = static_cast<uint64_t>(total);
+
+        if (reportFactors)
+            cout << "Expansion " << factor << ", total distances: " << sumDistances << '\n';
+        else
+            cout << "Total distances: " << sumDistances << '\n';
+    }
 
     return 0;
 }
+
+}  // namespace puzzle11b
+
+
+AOC_PUZZLE_MAIN(11b)
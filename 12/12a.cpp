@@ -102,14 +102,32 @@
 // What is the sum of those counts?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <numeric>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <spanstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "input.h"
+#include "puzzle.h"
+
 using namespace std;
 
-const bool debug = true;
+namespace puzzle12a {
+
+AOC_PUZZLE_STREAMS
+
+bool debug = true;   // Cleared with the `--quiet` (`-q`) command-line option.
 
 class SpringGroup {
   public:
@@ -123,9 +141,9 @@ class SpringGroup {
 
 class SpringSet {
   public:
-    SpringSet(string text) {
+    SpringSet(string_view text) {
         //if (debug) cout << "\n<" << text << ">\n";
-        stringstream iss(text);
+        ispanstream iss(text);
         iss >> springsText;
         string numbers;
         iss >> numbers;
@@ -165,82 +183,363 @@ class SpringSet {
 };
 
 
-bool isGood(const string& springsText, int pos) {
-    if (pos < 0 || pos >= springsText.size()) return true;
-    auto c = springsText[pos];
-    return (c == '?' || c == '.');
-}
+class ArrangementCounter {
+    // Counts the arrangements of a spring set with dynamic programming over (group, position). Let ways[g][i] be the
+    // number of ways to place the first g groups within the first i springs. Then either spring i-1 is operational,
+    // extending ways[g][i-1], or group g ends right at position i, extending ways[g-1] from just before the group's
+    // separating spring. Two precomputed arrays make each of those tests constant time, so a row is solved in
+    // O(length × groups). Only two rows of the table are kept, and all buffers are reused from one spring set to the
+    // next.
 
-bool isBad(const string& springsText, int pos) {
-    if (pos < 0 || pos >= springsText.size()) return false;
-    auto c = springsText[pos];
-    return (c == '?' || c == '#');
-}
+  public:
+    uint64_t count(const SpringSet& springSet) {
+        const string& springs = springSet.springsText;
+        const int n = springs.size();
 
-bool matchRun(const string& springsText, int pos, int length) {
-    if (pos > 0 && !isGood(springsText, pos-1))
-        return false;
-    if (pos < springsText.size() - length && !isGood(springsText, pos+length))
-        return false;
-    for (int i=pos;  i < pos+length;  ++i) {
-        if (!isBad(springsText, i))
+        if (n <= maxMaskedLength)
+            return countMasked(springSet);
+
+        // runLength[i] is the length of the longest run of possibly-broken springs ending just before position i, and
+        // brokenBefore[i] is the number of definitely-broken springs before position i.
+
+        runLength.assign(n + 1, 0);
+        brokenBefore.assign(n + 1, 0);
+
+        for (int i = 0;  i < n;  ++i) {
+            runLength[i+1]    = (springs[i] == '.') ? 0 : runLength[i] + 1;
+            brokenBefore[i+1] = brokenBefore[i] + (springs[i] == '#');
+        }
+
+        // With no groups placed, there's one way to cover any prefix without broken springs.
+
+        previous.assign(n + 1, 0);
+        for (int i = 0;  i <= n && brokenBefore[i] == 0;  ++i)
+            previous[i] = 1;
+
+        for (const auto& group : springSet.groups) {
+            const int length = group.length;
+
+            current.assign(n + 1, 0);
+
+            for (int i = 1;  i <= n;  ++i) {
+                uint64_t ways = (springs[i-1] != '#') ? current[i-1] : 0;
+
+                if (i >= length && runLength[i] >= length) {
+                    const int start = i - length;
+                    if (start == 0)
+                        ways += previous[0];
+                    else if (springs[start-1] != '#')
+                        ways += previous[start-1];
+                }
+
+                current[i] = ways;
+            }
+
+            swap(previous, current);
+        }
+
+        return previous[n];
+    }
+
+  private:
+    static const int maxMaskedLength = 64;
+
+    uint64_t countMasked(const SpringSet& springSet) {
+        // The same DP for rows of up to 64 springs, with the row held as two bitmasks: springs that may be broken
+        // ('?' or '#') and springs that must be broken ('#'). Whether a group of length L can start at each position is
+        // then computed for all positions at once with word-level shifts and ANDs, and the DP steps only test bits.
+
+        const string& springs = springSet.springsText;
+        const int n = springs.size();
+        const uint64_t one = 1;
+
+        uint64_t mayBeBroken  = 0;
+        uint64_t mustBeBroken = 0;
+
+        for (int i = 0;  i < n;  ++i) {
+            if (springs[i] != '.')
+                mayBeBroken  |= one << i;
+            if (springs[i] == '#')
+                mustBeBroken |= one << i;
+        }
+
+        // A group can start at position p only if spring p-1 may be operational (or p is zero).
+        const uint64_t separatedStarts = (~mustBeBroken << 1) | one;
+
+        auto canBeOperational = [&](int i) { return !((mustBeBroken >> i) & one); };
+
+        previous.assign(n + 1, 0);
+        for (int i = 0;  i <= n && (i == 0 || canBeOperational(i-1));  ++i)
+            previous[i] = 1;
+
+        for (const auto& group : springSet.groups) {
+            const int length = group.length;
+
+            // Bit p of runStarts is set when springs p through p+length-1 may all be broken.
+            uint64_t runStarts = (length <= n) ? mayBeBroken : 0;
+            for (int k = 1;  k < length && runStarts;  ++k)
+                runStarts &= mayBeBroken >> k;
+
+            const uint64_t starts = runStarts & separatedStarts;
+
+            current.assign(n + 1, 0);
+
+            for (int i = 1;  i <= n;  ++i) {
+                uint64_t ways = canBeOperational(i-1) ? current[i-1] : 0;
+
+                const int start = i - length;
+                if (start >= 0 && ((starts >> start) & one))
+                    ways += previous[start == 0 ? 0 : start-1];
+
+                current[i] = ways;
+            }
+
+            swap(previous, current);
+        }
+
+        return previous[n];
+    }
+
+    vector<int>      runLength;
+    vector<int>      brokenBefore;
+    vector<uint64_t> previous;
+    vector<uint64_t> current;
+};
+
+
+class ArrangementCache {
+    // A content-addressed cache of arrangement counts, shared across rows. Rows are keyed by a canonical form of their
+    // springs and groups: runs of operational springs are collapsed to one (and dropped at either end), since they
+    // don't affect the count, and a row and its reversal share the lesser of their two keys. The cache can be loaded
+    // from and saved to a snapshot file, one "key<tab>count" line per entry, so repeated runs also share results.
+
+  public:
+    static string canonicalKey(const string& springs, const vector<int>& groups) {
+        string forward;
+        for (auto c : springs) {
+            if (c != '.')
+                forward += c;
+            else if (!forward.empty() && forward.back() != '.')
+                forward += '.';
+        }
+        if (!forward.empty() && forward.back() == '.')
+            forward.pop_back();
+
+        string backward(forward.rbegin(), forward.rend());
+
+        forward  += ' ';
+        backward += ' ';
+        for (size_t i = 0;  i < groups.size();  ++i) {
+            if (i > 0) {
+                forward  += ',';
+                backward += ',';
+            }
+            forward  += to_string(groups[i]);
+            backward += to_string(groups[groups.size() - 1 - i]);
+        }
+
+        return min(forward, backward);
+    }
+
+    bool find(const string& key, uint64_t& count) const {
+        auto it = counts.find(key);
+        if (it == counts.end())
             return false;
+        count = it->second;
+        return true;
     }
-    return true;
+
+    void insert(const string& key, uint64_t count) {
+        counts[key] = count;
+    }
+
+    bool load(const string& path) {
+        // Loads entries from a snapshot file. Returns false, leaving the cache unchanged, if the file can't be read or
+        // any of it is malformed.
+
+        ifstream file(path);
+        if (!file)
+            return false;
+
+        unordered_map<string, uint64_t> loaded;
+        string line;
+        while (getline(file, line)) {
+            auto tab = line.rfind('\t');
+            uint64_t count = 0;
+            if (tab == string::npos || !parseCount(string_view(line).substr(tab + 1), count))
+                return false;
+            loaded[line.substr(0, tab)] = count;
+        }
+
+        counts.swap(loaded);
+        return true;
+    }
+
+    bool save(const string& path) const {
+        ofstream file(path);
+        for (const auto& [key, count] : counts)
+            file << key << '\t' << count << '\n';
+        return bool(file);
+    }
+
+  private:
+    static bool parseCount(string_view digits, uint64_t& count) {
+        // Parses a decimal count. Returns false if it's malformed or too large.
+        if (digits.empty())
+            return false;
+        count = 0;
+        for (auto c : digits) {
+            if (c < '0' || '9' < c)
+                return false;
+            if (__builtin_mul_overflow(count, 10u, &count) || __builtin_add_overflow(count, uint64_t(c - '0'), &count))
+                return false;
+        }
+        return true;
+    }
+
+    unordered_map<string, uint64_t> counts;
+};
+
+
+vector<uint64_t> countAll(const vector<const SpringSet*>& springSets, unsigned numThreads) {
+    // Counts the arrangements of each of the given spring sets. Rows are handed out longest first, so the slowest rows
+    // don't end up trailing behind everything else, to worker threads that each reuse their own DP scratch buffers.
+
+    vector<size_t> order(springSets.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return springSets[a]->springsText.size() > springSets[b]->springsText.size();
+    });
+
+    vector<uint64_t> counts(springSets.size(), 0);
+    atomic<size_t> next {0};
+
+    auto worker = [&]() {
+        ArrangementCounter counter;
+        for (size_t i;  (i = next.fetch_add(1)) < order.size(); ) {
+            const size_t row = order[i];
+            counts[row] = counter.count(*springSets[row]);
+        }
+    };
+
+    vector<thread> threads;
+    for (unsigned t = 1;  t < numThreads;  ++t)
+        threads.emplace_back(worker);
+    worker();
+
+    for (auto& t : threads)
+        t.join();
+
+    return counts;
 }
 
-bool remainderGood(const string& springsText, int pos) {
-    for (int i=pos;  i < springsText.size();  ++i) {
-        if (!isGood(springsText, i))
+
+bool parseThreadCount(string_view digits, unsigned& count) {
+    // Parses a decimal thread count. Returns false if the string is empty, contains a non-digit, or overflows.
+
+    if (digits.empty())
+        return false;
+
+    count = 0;
+    for (auto c : digits) {
+        if (c < '0' || '9' < c)
+            return false;
+        const unsigned digit = c - '0';
+        if (count > (UINT_MAX - digit) / 10)
             return false;
+        count = 10*count + digit;
     }
     return true;
 }
 
-uint64_t countArrangements(const SpringSet& springSet, int groupIndex, int startPos) {
-    uint64_t sumArrangements = 0;
-    auto& springGroup = springSet.groups[groupIndex];
-    auto groupLength = springGroup.length;
-    for (auto pos = startPos;  pos <= springGroup.rangeEnd;  ++pos) {
-        if (matchRun(springSet.springsText, pos, groupLength)) {
-            if (groupIndex == springSet.groups.size() - 1) {
-                if (remainderGood(springSet.springsText, pos + groupLength + 1))
-                    sumArrangements += 1;
-            } else {
-                sumArrangements += countArrangements(springSet, groupIndex + 1, pos + groupLength + 1);
+
+int solve(int argc, char* argv[]) {
+    string   cachePath;        // Set with `--cache <file>` to load and save an arrangement snapshot.
+    unsigned numThreads = 1;   // Set with `--threads <n>` (0 for all hardware threads).
+
+    for (int i = 1;  i < argc;  ++i) {
+        string_view arg {argv[i]};
+        if (arg == "--cache" && i+1 < argc)
+            cachePath = argv[++i];
+        else if (arg == "--threads" && i+1 < argc) {
+            if (!parseThreadCount(argv[++i], numThreads)) {
+                cerr << "Error: Bad value '" << argv[i] << "' for option '" << arg << "'.\n";
+                return 1;
             }
+            if (numThreads == 0)
+                numThreads = max(1u, thread::hardware_concurrency());
+        } else if (arg == "-q" || arg == "--quiet")
+            debug = false;
+        else {
+            cerr << "Error: Unrecognized option '" << arg << "'.\n";
+            return 1;
         }
     }
-    return sumArrangements;
-}
 
-int main() {
+    ArrangementCache cache;
+    if (!cachePath.empty() && !cache.load(cachePath))
+        cerr << "Note: Starting with an empty arrangement cache.\n";
+
+    aoc::Input input;
     vector<SpringSet> springSets;
-    vector<string> lines;
-    string line;
-    while (getline(cin, line))
+    string_view line;
+    while (input.getline(line))
         springSets.push_back({line});
 
-    if (debug) {
-        for (auto& ss : springSets) {
-            cout << '(' << ss.springsText << ")\n";
-            for (auto& sg : ss.groups)
-                cout << "  (" << sg.length << ") " << sg.rangeStart << '-' << sg.rangeEnd << '\n';
-            cout << "  Num Arrangements: " << countArrangements(ss, 0, 0) << '\n';
-            cout << '\n';
+    // Gather the distinct rows that aren't already cached, and count those.
+
+    vector<string>           keys;
+    vector<const SpringSet*> work;
+    vector<string>           workKeys;
+    unordered_set<string>    pending;
+
+    for (const auto& springSet : springSets) {
+        vector<int> groupLengths;
+        for (auto& group : springSet.groups)
+            groupLengths.push_back(group.length);
+
+        keys.push_back(ArrangementCache::canonicalKey(springSet.springsText, groupLengths));
+
+        uint64_t numArrangements;
+        if (!cache.find(keys.back(), numArrangements) && pending.insert(keys.back()).second) {
+            work.push_back(&springSet);
+            workKeys.push_back(keys.back());
         }
     }
 
+    const auto counts = countAll(work, numThreads);
+
+    for (size_t i = 0;  i < work.size();  ++i)
+        cache.insert(workKeys[i], counts[i]);
+
+    // Sum the counts for every row, reporting each one when debugging.
+
     uint64_t totalArrangements = 0;
-    for (auto& springSet : springSets) {
-        auto numArrangements = countArrangements(springSet, 0, 0);
+
+    for (size_t i = 0;  i < springSets.size();  ++i) {
+        uint64_t numArrangements = 0;
+        cache.find(keys[i], numArrangements);
+
         if (debug) {
-            cout << "Number Arrangements: " << numArrangements << " (" << springSet.springsText << ")\n";
+            const auto& ss = springSets[i];
+            cout << '(' << ss.springsText << ")\n";
+            for (auto& sg : ss.groups)
+                cout << "  (" << sg.length << ") " << sg.rangeStart << '-' << sg.rangeEnd << '\n';
+            cout << "  Num Arrangements: " << numArrangements << "\n\n";
         }
+
         totalArrangements += numArrangements;
     }
 
+    if (!cachePath.empty() && !cache.save(cachePath))
+        cerr << "Error: Could not save arrangement cache to '" << cachePath << "'.\n";
+
     cout << "Total arrangements: " << totalArrangements << '\n';
 
     return 0;
 }
+
+}  // namespace puzzle12a
+
+
+AOC_PUZZLE_MAIN(12a)
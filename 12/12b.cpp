@@ -1,21 +1,490 @@
 //----------------------------------------------------------------------------------------------------------------------
 // 2023 Advent of Code -- Puzzle 12b (See Part Two below)
 //
+// --- Day 12: Hot Springs ---
+//
+// (See 12a.cpp for Part One.)
+//
+// --- Part Two ---
+//
+// Each row of the condition records is actually folded. To unfold a row, replace its list of spring conditions with
+// five copies of itself separated by '?', and replace its list of contiguous group sizes with five copies of itself.
+//
+// For example, the row ".# 1" unfolds to ".#?.#?.#?.#?.# 1,1,1,1,1".
+//
+// Unfold your condition records; what is the new sum of possible arrangement counts?
 //----------------------------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <numeric>
+#include <spanstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "input.h"
+#include "puzzle.h"
 
 using namespace std;
 
+namespace puzzle12b {
+
+AOC_PUZZLE_STREAMS
+
+using uint128 = unsigned __int128;
+
+const int defaultFoldFactor = 5;
+
+
+class SpringSet {
+  public:
+    SpringSet(string_view text, int foldFactor) {
+        // Reads a folded row and unfolds it by the given factor.
+
+        ispanstream iss(text);
+        string foldedSprings;
+        iss >> foldedSprings;
+
+        vector<int> foldedGroups;
+        string numbers;
+        iss >> numbers;
+        while (numbers.size() > 0) {
+            foldedGroups.push_back(stoi(numbers));
+            auto sepPos = numbers.find(',');
+            if (sepPos == string::npos)
+                break;
+            numbers.erase(numbers.begin(), numbers.begin() + sepPos + 1);
+        }
+
+        for (int i = 0;  i < foldFactor;  ++i) {
+            if (i > 0)
+                springsText += '?';
+            springsText += foldedSprings;
+            groups.insert(groups.end(), foldedGroups.begin(), foldedGroups.end());
+        }
+    }
+
+    string springsText;
+    vector<int> groups;
+};
+
+
+class ArrangementCounter {
+    // Counts the arrangements of a spring set with dynamic programming over (group, position), as in 12a. Let
+    // ways[g][i] be the number of ways to place the first g groups within the first i springs. Then either spring i-1
+    // is operational, extending ways[g][i-1], or group g ends right at position i, extending ways[g-1] from just before
+    // the group's separating spring. Memory is bounded by two table rows, regardless of the number of groups, and
+    // counts are kept in 128 bits since unfolded rows overflow 64 bits at large fold factors.
+
+  public:
+    bool count(const SpringSet& springSet, uint128& numArrangements) {
+        // Returns false if the count overflows 128 bits.
+
+        const string& springs = springSet.springsText;
+        const int n = springs.size();
+
+        if (n <= maxMaskedLength)
+            return countMasked(springSet, numArrangements);
+
+        // runLength[i] is the length of the longest run of possibly-broken springs ending just before position i, and
+        // brokenBefore[i] is the number of definitely-broken springs before position i.
+
+        runLength.assign(n + 1, 0);
+        brokenBefore.assign(n + 1, 0);
+
+        for (int i = 0;  i < n;  ++i) {
+            runLength[i+1]    = (springs[i] == '.') ? 0 : runLength[i] + 1;
+            brokenBefore[i+1] = brokenBefore[i] + (springs[i] == '#');
+        }
+
+        // With no groups placed, there's one way to cover any prefix without broken springs.
+
+        previous.assign(n + 1, 0);
+        previousOverflow.assign(n + 1, false);
+        for (int i = 0;  i <= n && brokenBefore[i] == 0;  ++i)
+            previous[i] = 1;
+
+        for (const auto length : springSet.groups) {
+            current.assign(n + 1, 0);
+            currentOverflow.assign(n + 1, false);
+
+            for (int i = 1;  i <= n;  ++i) {
+                uint128 ways = 0;
+                bool overflow = false;
+
+                if (springs[i-1] != '#') {
+                    ways = current[i-1];
+                    overflow = currentOverflow[i-1];
+                }
+
+                if (i >= length && runLength[i] >= length) {
+                    const int start = i - length;
+                    if (start == 0 || springs[start-1] != '#')
+                        addCell(ways, overflow, start == 0 ? 0 : start-1);
+                }
 
-int main() {
-    string line;
-    int sum = 0;
+                current[i] = ways;
+                currentOverflow[i] = overflow;
+            }
 
-    while (getline(cin, line)) {
+            swap(previous, current);
+            swap(previousOverflow, currentOverflow);
+        }
+
+        numArrangements = previous[n];
+        return !previousOverflow[n];
+    }
+
+  private:
+    static const int maxMaskedLength = 128;
+
+    bool countMasked(const SpringSet& springSet, uint128& numArrangements) {
+        // The same DP for rows of up to 128 springs, with the row held as two bitmasks: springs that may be broken
+        // ('?' or '#') and springs that must be broken ('#'). Whether a group of length L can start at each position is
+        // then computed for all positions at once with word-level shifts and ANDs, and the DP steps only test bits.
+
+        const string& springs = springSet.springsText;
+        const int n = springs.size();
+        const uint128 one = 1;
+
+        uint128 mayBeBroken  = 0;
+        uint128 mustBeBroken = 0;
+
+        for (int i = 0;  i < n;  ++i) {
+            if (springs[i] != '.')
+                mayBeBroken  |= one << i;
+            if (springs[i] == '#')
+                mustBeBroken |= one << i;
+        }
+
+        // A group can start at position p only if spring p-1 may be operational (or p is zero).
+        const uint128 separatedStarts = (~mustBeBroken << 1) | one;
+
+        auto canBeOperational = [&](int i) { return !((mustBeBroken >> i) & one); };
+
+        previous.assign(n + 1, 0);
+        previousOverflow.assign(n + 1, false);
+        for (int i = 0;  i <= n && (i == 0 || canBeOperational(i-1));  ++i)
+            previous[i] = 1;
+
+        for (const auto length : springSet.groups) {
+            // Bit p of runStarts is set when springs p through p+length-1 may all be broken.
+            uint128 runStarts = (length <= n) ? mayBeBroken : 0;
+            for (int k = 1;  k < length && runStarts;  ++k)
+                runStarts &= mayBeBroken >> k;
+
+            const uint128 starts = runStarts & separatedStarts;
+
+            current.assign(n + 1, 0);
+            currentOverflow.assign(n + 1, false);
+
+            for (int i = 1;  i <= n;  ++i) {
+                uint128 ways = 0;
+                bool overflow = false;
+
+                if (canBeOperational(i-1)) {
+                    ways = current[i-1];
+                    overflow = currentOverflow[i-1];
+                }
+
+                const int start = i - length;
+                if (start >= 0 && ((starts >> start) & one))
+                    addCell(ways, overflow, start == 0 ? 0 : start-1);
+
+                current[i] = ways;
+                currentOverflow[i] = overflow;
+            }
+
+            swap(previous, current);
+            swap(previousOverflow, currentOverflow);
+        }
+
+        numArrangements = previous[n];
+        return !previousOverflow[n];
     }
 
-    cout << sum << '\n';
+    void addCell(uint128& ways, bool& overflow, int from) const {
+        // Adds the previous row's cell to a running count. A cell that has wrapped only marks the cells it feeds, so
+        // prefix counts that grow past 128 bits but can never be completed don't fail a row whose total fits.
+
+        overflow |= previousOverflow[from];
+        overflow |= __builtin_add_overflow(ways, previous[from], &ways);
+    }
+
+    vector<int>     runLength;
+    vector<int>     brokenBefore;
+    vector<uint128> previous;
+    vector<uint128> current;
+    vector<bool>    previousOverflow;   // Cells that have wrapped, or that a wrapped cell feeds
+    vector<bool>    currentOverflow;
+};
+
+
+string toString(uint128 value) {
+    // Formats an unsigned 128-bit value in decimal.
+
+    string digits;
+    do {
+        digits.insert(digits.begin(), char('0' + int(value % 10)));
+        value /= 10;
+    } while (value > 0);
+    return digits;
+}
+
+
+class ArrangementCache {
+    // A content-addressed cache of arrangement counts, shared across rows. Rows are keyed by a canonical form of their
+    // springs and groups: runs of operational springs are collapsed to one (and dropped at either end), since they
+    // don't affect the count, and a row and its reversal share the lesser of their two keys. The cache can be loaded
+    // from and saved to a snapshot file, one "key<tab>count" line per entry, so repeated runs also share results.
+
+  public:
+    static string canonicalKey(const string& springs, const vector<int>& groups) {
+        string forward;
+        for (auto c : springs) {
+            if (c != '.')
+                forward += c;
+            else if (!forward.empty() && forward.back() != '.')
+                forward += '.';
+        }
+        if (!forward.empty() && forward.back() == '.')
+            forward.pop_back();
+
+        string backward(forward.rbegin(), forward.rend());
+
+        forward  += ' ';
+        backward += ' ';
+        for (size_t i = 0;  i < groups.size();  ++i) {
+            if (i > 0) {
+                forward  += ',';
+                backward += ',';
+            }
+            forward  += to_string(groups[i]);
+            backward += to_string(groups[groups.size() - 1 - i]);
+        }
+
+        return min(forward, backward);
+    }
+
+    bool find(const string& key, uint128& count) const {
+        auto it = counts.find(key);
+        if (it == counts.end())
+            return false;
+        count = it->second;
+        return true;
+    }
+
+    void insert(const string& key, uint128 count) {
+        counts[key] = count;
+    }
+
+    bool load(const string& path) {
+        // Loads entries from a snapshot file. Returns false, leaving the cache unchanged, if the file can't be read or
+        // any of it is malformed.
+
+        ifstream file(path);
+        if (!file)
+            return false;
+
+        unordered_map<string, uint128> loaded;
+        string line;
+        while (getline(file, line)) {
+            auto tab = line.rfind('\t');
+            uint128 count = 0;
+            if (tab == string::npos || !parseCount(string_view(line).substr(tab + 1), count))
+                return false;
+            loaded[line.substr(0, tab)] = count;
+        }
+
+        counts.swap(loaded);
+        return true;
+    }
+
+    bool save(const string& path) const {
+        ofstream file(path);
+        for (const auto& [key, count] : counts)
+            file << key << '\t' << toString(count) << '\n';
+        return bool(file);
+    }
+
+  private:
+    static bool parseCount(string_view digits, uint128& count) {
+        // Parses a decimal count. Returns false if it's malformed or too large.
+        if (digits.empty())
+            return false;
+        count = 0;
+        for (auto c : digits) {
+            if (c < '0' || '9' < c)
+                return false;
+            if (__builtin_mul_overflow(count, 10u, &count) || __builtin_add_overflow(count, uint128(c - '0'), &count))
+                return false;
+        }
+        return true;
+    }
+
+    unordered_map<string, uint128> counts;
+};
+
+
+vector<uint128> countAll(const vector<const SpringSet*>& springSets, unsigned numThreads, vector<char>& valid) {
+    // Counts the arrangements of each of the given spring sets. Rows are handed out longest first, so the slowest rows
+    // don't end up trailing behind everything else, to worker threads that each reuse their own DP scratch buffers.
+
+    vector<size_t> order(springSets.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return springSets[a]->springsText.size() > springSets[b]->springsText.size();
+    });
+
+    vector<uint128> counts(springSets.size(), 0);
+    valid.assign(springSets.size(), false);
+    atomic<size_t> next {0};
+
+    auto worker = [&]() {
+        ArrangementCounter counter;
+        for (size_t i;  (i = next.fetch_add(1)) < order.size(); ) {
+            const size_t row = order[i];
+            valid[row] = counter.count(*springSets[row], counts[row]);
+        }
+    };
+
+    vector<thread> threads;
+    for (unsigned t = 1;  t < numThreads;  ++t)
+        threads.emplace_back(worker);
+    worker();
+
+    for (auto& t : threads)
+        t.join();
+
+    return counts;
+}
+
+
+bool parseUnsigned(string_view digits, unsigned& count) {
+    // Parses a decimal option value. Returns false if the string is empty, contains a non-digit, or overflows.
+
+    if (digits.empty())
+        return false;
+
+    count = 0;
+    for (auto c : digits) {
+        if (c < '0' || '9' < c)
+            return false;
+        const unsigned digit = c - '0';
+        if (count > (UINT_MAX - digit) / 10)
+            return false;
+        count = 10*count + digit;
+    }
+    return true;
+}
+
+
+int solve(int argc, char* argv[]) {
+    int      foldFactor = defaultFoldFactor;   // Set with `--fold <n>`.
+    string   cachePath;                        // Set with `--cache <file>` to load and save an arrangement snapshot.
+    unsigned numThreads = 1;                   // Set with `--threads <n>` (0 for all hardware threads).
+
+    for (int i = 1;  i < argc;  ++i) {
+        string_view arg {argv[i]};
+        if (arg == "--fold" && i+1 < argc) {
+            unsigned value;
+            if (!parseUnsigned(argv[++i], value) || value > INT_MAX) {
+                cerr << "Error: Bad value '" << argv[i] << "' for option '" << arg << "'.\n";
+                return 1;
+            }
+            if (value < 1) {
+                cerr << "Error: Fold factor must be at least one.\n";
+                return 1;
+            }
+            foldFactor = value;
+        } else if (arg == "--cache" && i+1 < argc) {
+            cachePath = argv[++i];
+        } else if (arg == "--threads" && i+1 < argc) {
+            if (!parseUnsigned(argv[++i], numThreads)) {
+                cerr << "Error: Bad value '" << argv[i] << "' for option '" << arg << "'.\n";
+                return 1;
+            }
+            if (numThreads == 0)
+                numThreads = max(1u, thread::hardware_concurrency());
+        } else {
+            cerr << "Error: Unrecognized option '" << arg << "'.\n";
+            return 1;
+        }
+    }
+
+    ArrangementCache cache;
+    if (!cachePath.empty() && !cache.load(cachePath))
+        cerr << "Note: Starting with an empty arrangement cache.\n";
+
+    aoc::Input input;
+    vector<SpringSet> springSets;
+    string_view line;
+
+    while (input.getline(line)) {
+        if (!line.empty())
+            springSets.push_back({line, foldFactor});
+    }
+
+    // Gather the distinct rows that aren't already cached, and count those.
+
+    vector<string>           keys;
+    vector<const SpringSet*> work;
+    vector<string>           workKeys;
+    unordered_set<string>    pending;
+
+    for (const auto& springSet : springSets) {
+        keys.push_back(ArrangementCache::canonicalKey(springSet.springsText, springSet.groups));
+
+        uint128 numArrangements;
+        if (!cache.find(keys.back(), numArrangements) && pending.insert(keys.back()).second) {
+            work.push_back(&springSet);
+            workKeys.push_back(keys.back());
+        }
+    }
+
+    vector<char> valid;
+    const auto counts = countAll(work, numThreads, valid);
+
+    for (size_t i = 0;  i < work.size();  ++i) {
+        if (!valid[i]) {
+            cerr << "Error: Total arrangements overflow 128 bits.\n";
+            return 1;
+        }
+        cache.insert(workKeys[i], counts[i]);
+    }
+
+    // Sum the counts for every row.
+
+    uint128 totalArrangements = 0;
+
+    for (const auto& key : keys) {
+        uint128 numArrangements = 0;
+        cache.find(key, numArrangements);
+
+        if (__builtin_add_overflow(totalArrangements, numArrangements, &totalArrangements)) {
+            cerr << "Error: Total arrangements overflow 128 bits.\n";
+            return 1;
+        }
+    }
+
+    if (!cachePath.empty() && !cache.save(cachePath))
+        cerr << "Error: Could not save arrangement cache to '" << cachePath << "'.\n";
+
+    cout << "Total arrangements: " << toString(totalArrangements) << '\n';
+
     return 0;
 }
+
+}  // namespace puzzle12b
+
+
+AOC_PUZZLE_MAIN(12b)
@@ -5,17 +5,31 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+
+#include "input.h"
+#include "puzzle.h"
 
 using namespace std;
 
+namespace puzzle13b {
+
+AOC_PUZZLE_STREAMS
+
 
-int main() {
-    string line;
+int solve(int argc, char* argv[]) {
+    aoc::Input input;
+    string_view line;
     int sum = 0;
 
-    while (getline(cin, line)) {
+    while (input.getline(line)) {
     }
 
     cout << sum << '\n';
     return 0;
 }
+
+}  // namespace puzzle13b
+
+
+AOC_PUZZLE_MAIN(13b)
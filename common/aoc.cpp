@@ -0,0 +1,328 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Multi-Puzzle Runner
+//
+// Links every puzzle solver into a single executable and runs any list of them in one process. Each solver is
+// registered by name (see puzzle.h), and the runner maps each puzzle's input into memory, supplies it to the solver
+// (see input.h), and captures the solver's output.
+//
+// Usage: aoc [--root <dir>] [--jobs <n>] [--list] [all | <day> | <puzzle>]...
+//
+//     <day> is a two-digit day number such as `07` (running both parts), and <puzzle> is a puzzle name such as `07b`.
+//     With no puzzles given, all puzzles are run. Puzzles are run with no command-line options.
+//
+//     Puzzles run concurrently on `--jobs` worker threads (default: all hardware threads; 1 runs them one at a time).
+//     Each worker takes puzzles from its own queue and steals from the others when its queue runs dry. The
+//     longest-running puzzles are scheduled first, so a full run takes about as long as the slowest single puzzle.
+//     Results are printed in day order as soon as each puzzle and all puzzles before it have finished.
+//
+//     Puzzle input is read from `<root>/<day>/`, trying `input-<puzzle>.txt`, then `input-<day>a.txt` (part two
+//     usually shares part one's input), then `input.txt`. Puzzles without input are skipped. The root defaults to the
+//     source directory this runner was built from.
+//----------------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "input.h"
+#include "puzzle.h"
+
+using namespace std;
+
+#if !defined(AOC_SOURCE_DIR)
+    #define AOC_SOURCE_DIR "."
+#endif
+
+
+bool findInput(const filesystem::path& root, const string& puzzleName, filesystem::path& inputPath) {
+    // Locates the input file for the given puzzle. Returns false if none was found.
+
+    const string day = puzzleName.substr(0, 2);
+    const filesystem::path dayDir = root / day;
+
+    for (const auto& fileName : { "input-" + puzzleName + ".txt", "input-" + day + "a.txt", string("input.txt") }) {
+        if (filesystem::is_regular_file(dayDir / fileName)) {
+            inputPath = dayDir / fileName;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+int runPuzzle(const aoc::Puzzle& puzzle, string_view input, string& output) {
+    // Runs the given puzzle solver on the given input, on the current thread, capturing its output. Returns the
+    // solver's exit code.
+
+    ostringstream outputBuffer;
+    ostream& out = aoc::threadOutput();
+
+    aoc::Input::setThreadInput(input);
+    out.rdbuf(outputBuffer.rdbuf());
+
+    string programName = puzzle.name;
+    char* argv[] { programName.data(), nullptr };
+    const int result = puzzle.solve(1, argv);
+
+    aoc::Input::clearThreadInput();
+    out.rdbuf(nullptr);
+
+    output = std::move(outputBuffer).str();
+    return result;
+}
+
+
+bool selectPuzzles(const vector<string>& requests, vector<const aoc::Puzzle*>& selected) {
+    // Resolves the requested puzzles and days to registered puzzles, in day order without duplicates. Returns false on
+    // an unknown request.
+
+    const auto& puzzles = aoc::puzzles();
+    vector<bool> isSelected(puzzles.size(), requests.empty());
+
+    for (const auto& request : requests) {
+        bool found = false;
+
+        for (size_t i = 0;  i < puzzles.size();  ++i) {
+            const auto& name = puzzles[i].name;
+            if (request == "all" || name == request || name.substr(0, 2) == request) {
+                isSelected[i] = true;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            cerr << "Error: Unknown puzzle \"" << request << "\".\n";
+            return false;
+        }
+    }
+
+    for (size_t i = 0;  i < puzzles.size();  ++i) {
+        if (isSelected[i])
+            selected.push_back(&puzzles[i]);
+    }
+
+    return true;
+}
+
+
+struct PuzzleRun {
+    const aoc::Puzzle* puzzle;
+    aoc::Input         input    {string_view()};   // Empty (rather than standard input) until opened
+    bool               hasInput {false};
+    string             output   {};
+    int                result   {0};
+    double             seconds  {0.0};
+    bool               finished {false};
+};
+
+
+// The longest-running puzzles, slowest first. These are scheduled ahead of all others, which follow in order of
+// decreasing input size.
+const string_view slowPuzzles[] { "05b", "08b", "12b" };
+
+
+vector<size_t> scheduleOrder(const vector<PuzzleRun>& runs) {
+    // Returns the indices of the given puzzle runs, in the order they should be started.
+
+    auto slowRank = [](const aoc::Puzzle* puzzle) {
+        auto it = find(begin(slowPuzzles), end(slowPuzzles), puzzle->name);
+        return static_cast<size_t>(it - begin(slowPuzzles));
+    };
+
+    vector<size_t> order;
+    for (size_t i = 0;  i < runs.size();  ++i)
+        order.push_back(i);
+
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const size_t rankA = slowRank(runs[a].puzzle);
+        const size_t rankB = slowRank(runs[b].puzzle);
+        if (rankA != rankB)
+            return rankA < rankB;
+        return runs[a].input.size() > runs[b].input.size();
+    });
+
+    return order;
+}
+
+
+class WorkQueue {
+    // One worker's queue of puzzle run indices. The owner takes work from the front (the longest remaining jobs), and
+    // other workers steal from the back.
+
+  public:
+    void push(size_t index) {
+        lock_guard lock {mutex_};
+        indices.push_back(index);
+    }
+
+    bool take(size_t& index) {
+        lock_guard lock {mutex_};
+        if (indices.empty())
+            return false;
+        index = indices.front();
+        indices.pop_front();
+        return true;
+    }
+
+    bool steal(size_t& index) {
+        lock_guard lock {mutex_};
+        if (indices.empty())
+            return false;
+        index = indices.back();
+        indices.pop_back();
+        return true;
+    }
+
+  private:
+    mutex         mutex_;
+    deque<size_t> indices;
+};
+
+
+void printRun(const PuzzleRun& run) {
+    cout << "--- " << run.puzzle->name;
+    if (run.hasInput)
+        cout << " (" << fixed << setprecision(3) << run.seconds << " s)";
+    cout << " ---\n";
+
+    if (!run.hasInput) {
+        cout << "(skipped: no input)\n\n";
+        return;
+    }
+
+    cout << run.output;
+    if (run.result != 0)
+        cout << "(exit code " << run.result << ")\n";
+    cout << '\n' << flush;
+}
+
+
+void runAll(vector<PuzzleRun>& runs, unsigned numWorkers) {
+    // Runs all given puzzles on a pool of work-stealing worker threads, printing each result in order as soon as it
+    // and every result before it are finished.
+
+    vector<WorkQueue> queues(numWorkers);
+    const auto order = scheduleOrder(runs);
+    for (size_t i = 0;  i < order.size();  ++i)
+        queues[i % numWorkers].push(order[i]);
+
+    mutex  printMutex;
+    size_t nextToPrint = 0;
+
+    auto worker = [&](unsigned id) {
+        while (true) {
+            size_t index;
+            bool found = queues[id].take(index);
+            for (unsigned offset = 1;  !found && offset < numWorkers;  ++offset)
+                found = queues[(id + offset) % numWorkers].steal(index);
+            if (!found)
+                return;   // No work is ever added once started, so every queue is now empty.
+
+            auto& run = runs[index];
+            if (run.hasInput) {
+                const auto start = chrono::steady_clock::now();
+                run.result = runPuzzle(*run.puzzle, run.input.text(), run.output);
+                run.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            }
+
+            lock_guard lock {printMutex};
+            run.finished = true;
+            while (nextToPrint < runs.size() && runs[nextToPrint].finished)
+                printRun(runs[nextToPrint++]);
+        }
+    };
+
+    vector<thread> threads;
+    for (unsigned id = 0;  id < numWorkers;  ++id)
+        threads.emplace_back(worker, id);
+
+    for (auto& t : threads)
+        t.join();
+}
+
+
+int main(int argc, char* argv[]) {
+    filesystem::path root {AOC_SOURCE_DIR};
+    unsigned numWorkers = max(1u, thread::hardware_concurrency());
+    bool listOnly = false;
+    vector<string> requests;
+
+    for (int argi = 1; argi < argc; ++argi) {
+        const string_view arg {argv[argi]};
+        if (arg == "--list") {
+            listOnly = true;
+        } else if (arg == "--root" || arg == "--jobs") {
+            if (++argi >= argc) {
+                cerr << "Error: Missing value for " << arg << " option.\n";
+                return 1;
+            }
+            if (arg == "--root") {
+                root = argv[argi];
+            } else {
+                numWorkers = static_cast<unsigned>(strtoul(argv[argi], nullptr, 10));
+                if (numWorkers == 0) {
+                    cerr << "Error: Bad value '" << argv[argi] << "' for option '--jobs'.\n";
+                    return 1;
+                }
+            }
+        } else if (arg.starts_with("-")) {
+            cerr << "Error: Unrecognized option \"" << arg << "\".\n";
+            return 1;
+        } else {
+            requests.emplace_back(arg);
+        }
+    }
+
+    auto& puzzles = aoc::puzzles();
+    sort(puzzles.begin(), puzzles.end(), [](const aoc::Puzzle& a, const aoc::Puzzle& b) { return a.name < b.name; });
+
+    vector<const aoc::Puzzle*> selected;
+    if (!selectPuzzles(requests, selected))
+        return 1;
+
+    if (listOnly) {
+        for (const auto* puzzle : selected)
+            cout << puzzle->name << '\n';
+        return 0;
+    }
+
+    vector<PuzzleRun> runs;
+    int exitCode = 0;
+
+    for (const auto* puzzle : selected) {
+        PuzzleRun run {puzzle};
+        filesystem::path inputPath;
+        if (findInput(root, puzzle->name, inputPath)) {
+            if (!run.input.open(inputPath.string())) {
+                cerr << "Error: Unable to read input file \"" << inputPath.string() << "\".\n";
+                exitCode = 1;
+                continue;
+            }
+            run.hasInput = true;
+        }
+        runs.push_back(std::move(run));
+    }
+
+    const auto start = chrono::steady_clock::now();
+    runAll(runs, min<unsigned>(numWorkers, max<size_t>(1, runs.size())));
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    for (const auto& run : runs) {
+        if (run.result != 0)
+            exitCode = 1;
+    }
+
+    cout << "Ran " << runs.size() << " puzzles in " << fixed << setprecision(3) << seconds << " s\n";
+    return exitCode;
+}
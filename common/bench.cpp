@@ -0,0 +1,454 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Benchmark Harness
+//
+// Runs each puzzle executable repeatedly over its real input and over scaled-up copies of it, and reports the median
+// and 99th-percentile run times, throughput, and peak memory use. Each run is a separate process reading its input
+// from a file on standard input, exactly as the puzzle is normally run, so the peak resident set size reported for each
+// run is that puzzle's alone.
+//
+// Usage: aocbench [--bin <dir>] [--root <dir>] [--work <dir>] [--runs <n>] [--scales <n,...>] [--seed <n>]
+//                 [--timeout <seconds>] [--json <file>] [all | <day> | <puzzle>]...
+//
+//     <day> is a two-digit day number such as `07` (benchmarking both parts), and <puzzle> is a puzzle name such as
+//     `07b`. With no puzzles given, every puzzle that has an input file is benchmarked.
+//
+//     --bin <dir>           Directory holding the puzzle executables. Defaults to the build directory.
+//     --root <dir>          Root directory of the day directories holding puzzle input. Defaults to the source
+//                           directory.
+//     --work <dir>          Directory for the scaled inputs. Defaults to `bench-inputs` in the --bin directory.
+//     --runs <n>            Number of timed runs per puzzle and scale (default 10).
+//     --scales <n,...>      Input scale factors, where 1 is the real input (default 1,10,100,1000).
+//     --seed <n>            Random seed for the generated inputs (default 0).
+//     --timeout <seconds>   Time limit for a single run (default 60). Once the runs of one scale have taken this long
+//                           in total, no further runs are made at that scale. After a run times out or fails, larger
+//                           scales of that puzzle are skipped.
+//     --json <file>         Also write the results to the given file as JSON.
+//
+//     Puzzle input is found as for the `aoc` runner. Scaled inputs are generated (see generator.h) at the given
+//     multiple of the real input's size, and are reproducible for a given seed. Days without a generator are run on
+//     their real input only.
+//     Puzzles that support `--quiet` are run with it, so the timings cover solving rather than reporting.
+//----------------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "generator.h"
+#include "input.h"
+
+using namespace std;
+
+#if !defined(AOC_SOURCE_DIR)
+    #define AOC_SOURCE_DIR "."
+#endif
+
+#if !defined(AOC_PUZZLE_DIR)
+    #define AOC_PUZZLE_DIR "."
+#endif
+
+
+// Puzzles that accept `--quiet` to suppress their progress or per-line reports.
+const string_view quietPuzzles[] { "06a", "07a", "07b", "09a", "09b", "12a" };
+
+
+struct RunResult {
+    double seconds    {0.0};
+    long   peakRssKiB {0};
+    string status;              // "ok", "failed", "timeout", or "crashed"
+};
+
+
+struct Measurement {
+    string         puzzle;
+    unsigned       scale      {1};
+    size_t         bytes      {0};
+    size_t         lines      {0};
+    vector<double> seconds    {};       // One per completed run
+    long           peakRssKiB {0};      // Greatest over all runs
+    string         status     {"ok"};
+};
+
+
+bool findInput(const filesystem::path& root, const string& puzzleName, filesystem::path& inputPath) {
+    // Locates the input file for the given puzzle, as the `aoc` runner does. Returns false if none was found.
+
+    const string day = puzzleName.substr(0, 2);
+    const filesystem::path dayDir = root / day;
+
+    for (const auto& fileName : { "input-" + puzzleName + ".txt", "input-" + day + "a.txt", string("input.txt") }) {
+        if (filesystem::is_regular_file(dayDir / fileName)) {
+            inputPath = dayDir / fileName;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+size_t countLines(string_view text) {
+    size_t lines = count(text.begin(), text.end(), '\n');
+    if (!text.empty() && text.back() != '\n')
+        ++lines;
+    return lines;
+}
+
+
+RunResult runOnce(const filesystem::path& executable, const filesystem::path& inputPath, bool quiet, unsigned timeout)
+{
+    // Runs the puzzle executable once in a child process, with standard input read from the given file and standard
+    // output discarded. The child is sent SIGALRM (which terminates it) once the timeout has passed.
+
+    string program = executable.string();
+    string quietOption = "--quiet";
+    char* argv[] { program.data(), quiet ? quietOption.data() : nullptr, nullptr };
+
+    RunResult result;
+    const auto start = chrono::steady_clock::now();
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+        result.status = "failed";
+        return result;
+    }
+
+    if (pid == 0) {
+        const int inputFile  = open(inputPath.c_str(), O_RDONLY);
+        const int outputFile = open("/dev/null", O_WRONLY);
+        if (inputFile < 0 || outputFile < 0)
+            _exit(127);
+        dup2(inputFile, STDIN_FILENO);
+        dup2(outputFile, STDOUT_FILENO);
+
+        alarm(timeout);
+        execv(program.c_str(), argv);
+        _exit(127);
+    }
+
+    int status;
+    struct rusage usage;
+    while (wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR) {
+            result.status = "failed";
+            return result;
+        }
+    }
+
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+#if defined(__APPLE__)
+    result.peakRssKiB = usage.ru_maxrss / 1024;   // Reported in bytes rather than kibibytes
+#else
+    result.peakRssKiB = usage.ru_maxrss;
+#endif
+
+    if (WIFEXITED(status))
+        result.status = (WEXITSTATUS(status) == 0) ? "ok" : "failed";
+    else if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+        result.status = "timeout";
+    else
+        result.status = "crashed";
+
+    return result;
+}
+
+
+double percentile(vector<double> values, double fraction) {
+    // Returns the nearest-rank percentile of the given values (0 if there are none).
+
+    if (values.empty())
+        return 0.0;
+
+    sort(values.begin(), values.end());
+    const size_t rank = static_cast<size_t>(ceil(fraction * values.size()));
+    return values[max<size_t>(rank, 1) - 1];
+}
+
+
+void printHeader() {
+    cout << left  << setw(7)  << "Puzzle"
+         << right << setw(6)  << "Scale"
+         << setw(11) << "Input MB"
+         << setw(11) << "Lines"
+         << setw(6)  << "Runs"
+         << setw(12) << "Median ms"
+         << setw(12) << "p99 ms"
+         << setw(10) << "MB/s"
+         << setw(13) << "Lines/s"
+         << setw(10) << "RSS MB"
+         << "  Status\n";
+}
+
+
+void printRow(const Measurement& m) {
+    const double median = percentile(m.seconds, 0.50);
+    const double p99    = percentile(m.seconds, 0.99);
+    const double mb     = m.bytes / 1e6;
+
+    cout << left  << setw(7) << m.puzzle
+         << right << setw(6) << m.scale
+         << fixed << setprecision(3) << setw(11) << mb
+         << setw(11) << m.lines
+         << setw(6)  << m.seconds.size();
+
+    if (m.seconds.empty()) {
+        cout << setw(12) << "-" << setw(12) << "-" << setw(10) << "-" << setw(13) << "-";
+    } else {
+        cout << setprecision(2) << setw(12) << median * 1e3 << setw(12) << p99 * 1e3
+             << setprecision(1) << setw(10) << mb / median
+             << setprecision(0) << setw(13) << m.lines / median;
+    }
+
+    cout << setprecision(1) << setw(10) << m.peakRssKiB / 1024.0
+         << "  " << m.status << '\n' << flush;
+}
+
+
+bool writeJson(const string& path, const vector<Measurement>& measurements) {
+    ofstream out(path);
+    if (!out)
+        return false;
+
+    out << "[\n" << setprecision(9);
+
+    for (size_t i = 0;  i < measurements.size();  ++i) {
+        const auto& m = measurements[i];
+        const double median = percentile(m.seconds, 0.50);
+        const double p99    = percentile(m.seconds, 0.99);
+        const bool   timed  = !m.seconds.empty();
+
+        out << "  {\"puzzle\": \"" << m.puzzle << "\""
+            << ", \"scale\": " << m.scale
+            << ", \"bytes\": " << m.bytes
+            << ", \"lines\": " << m.lines
+            << ", \"runs\": " << m.seconds.size()
+            << ", \"seconds\": [";
+        for (size_t j = 0;  j < m.seconds.size();  ++j)
+            out << (j ? ", " : "") << m.seconds[j];
+        out << "]";
+
+        if (timed) {
+            out << ", \"median_seconds\": " << median
+                << ", \"p99_seconds\": " << p99
+                << ", \"mb_per_second\": " << m.bytes / 1e6 / median
+                << ", \"lines_per_second\": " << m.lines / median;
+        } else {
+            out << ", \"median_seconds\": null, \"p99_seconds\": null"
+                << ", \"mb_per_second\": null, \"lines_per_second\": null";
+        }
+
+        out << ", \"peak_rss_kib\": " << m.peakRssKiB
+            << ", \"status\": \"" << m.status << "\"}"
+            << (i + 1 < measurements.size() ? ",\n" : "\n");
+    }
+
+    out << "]\n";
+    return bool(out);
+}
+
+
+bool parseScales(string_view text, vector<unsigned>& scales) {
+    scales.clear();
+    istringstream stream {string(text)};
+    string item;
+    while (getline(stream, item, ',')) {
+        const unsigned long scale = strtoul(item.c_str(), nullptr, 10);
+        if (scale == 0)
+            return false;
+        scales.push_back(static_cast<unsigned>(scale));
+    }
+    return !scales.empty();
+}
+
+
+int main(int argc, char* argv[]) {
+    filesystem::path binDir  {AOC_PUZZLE_DIR};
+    filesystem::path root    {AOC_SOURCE_DIR};
+    filesystem::path workDir;
+    unsigned numRuns = 10;
+    unsigned timeout = 60;
+    uint64_t seed = 0;
+    vector<unsigned> scales {1, 10, 100, 1000};
+    string jsonPath;
+    vector<string> requests;
+
+    for (int argi = 1; argi < argc; ++argi) {
+        const string_view arg {argv[argi]};
+        if (arg == "--bin" || arg == "--root" || arg == "--work" || arg == "--runs" || arg == "--scales"
+                || arg == "--seed" || arg == "--timeout" || arg == "--json") {
+            if (++argi >= argc) {
+                cerr << "Error: Missing value for " << arg << " option.\n";
+                return 1;
+            }
+            const string value {argv[argi]};
+            bool good = true;
+
+            if (arg == "--bin")
+                binDir = value;
+            else if (arg == "--root")
+                root = value;
+            else if (arg == "--work")
+                workDir = value;
+            else if (arg == "--json")
+                jsonPath = value;
+            else if (arg == "--scales")
+                good = parseScales(value, scales);
+            else if (arg == "--seed")
+                seed = strtoull(value.c_str(), nullptr, 10);
+            else {
+                const unsigned long number = strtoul(value.c_str(), nullptr, 10);
+                good = (number > 0);
+                (arg == "--runs" ? numRuns : timeout) = static_cast<unsigned>(number);
+            }
+
+            if (!good) {
+                cerr << "Error: Bad value '" << value << "' for option '" << arg << "'.\n";
+                return 1;
+            }
+        } else if (arg.starts_with("-")) {
+            cerr << "Error: Unrecognized option \"" << arg << "\".\n";
+            return 1;
+        } else {
+            requests.emplace_back(arg);
+        }
+    }
+
+    if (workDir.empty())
+        workDir = binDir / "bench-inputs";
+
+    // Select puzzles by name or day, in day order.
+
+    vector<string> puzzles;
+    for (int day = 1;  day <= 25;  ++day) {
+        for (char part : {'a', 'b'}) {
+            ostringstream name;
+            name << setw(2) << setfill('0') << day << part;
+            const string puzzle = name.str();
+            filesystem::path inputPath;
+
+            const bool requested = requests.empty() || any_of(requests.begin(), requests.end(), [&](const string& r) {
+                return r == "all" || r == puzzle || r == puzzle.substr(0, 2);
+            });
+            if (requested && findInput(root, puzzle, inputPath) && filesystem::exists(binDir / puzzle))
+                puzzles.push_back(puzzle);
+        }
+    }
+
+    if (puzzles.empty()) {
+        cerr << "Error: No puzzles (with both input and executable) to benchmark.\n";
+        return 1;
+    }
+
+    error_code error;
+    filesystem::create_directories(workDir, error);
+    if (error) {
+        cerr << "Error: Unable to create directory \"" << workDir.string() << "\".\n";
+        return 1;
+    }
+
+    // Generate each day's scaled inputs once, on first use.
+
+    map<string, filesystem::path> scaledInputs;   // Keyed by day and scale, as in "07-x100"
+
+    auto inputFor = [&](const string& puzzle, const filesystem::path& realInput, unsigned scale,
+                        filesystem::path& inputPath) {
+        if (scale == 1) {
+            inputPath = realInput;
+            return true;
+        }
+
+        const string day = puzzle.substr(0, 2);
+        const string key = day + "-x" + to_string(scale);
+        if (auto it = scaledInputs.find(key);  it != scaledInputs.end()) {
+            inputPath = it->second;
+            return !inputPath.empty();
+        }
+
+        scaledInputs[key] = filesystem::path();   // Until successfully generated
+
+        aoc::Input input {string_view()};
+        if (aoc::generatorParameters(stoi(day)).empty() || !input.open(realInput.string()))
+            return false;
+
+        aoc::GeneratorOptions options;
+        options.seed = seed;
+        options.size = uint64_t(input.size()) * scale;
+
+        inputPath = workDir / ("input-" + key + ".txt");
+        ofstream file(inputPath, ios::binary);
+        if (!aoc::generateInput(stoi(day), options, file)) {
+            cerr << "Error: Unable to write \"" << inputPath.string() << "\".\n";
+            return false;
+        }
+
+        scaledInputs[key] = inputPath;
+        return true;
+    };
+
+    vector<Measurement> measurements;
+    bool anyFailed = false;
+
+    printHeader();
+
+    for (const auto& puzzle : puzzles) {
+        filesystem::path realInput;
+        findInput(root, puzzle, realInput);
+        const bool quiet = find(begin(quietPuzzles), end(quietPuzzles), puzzle) != end(quietPuzzles);
+
+        for (unsigned scale : scales) {
+            filesystem::path inputPath;
+            if (!inputFor(puzzle, realInput, scale, inputPath))
+                continue;
+
+            aoc::Input input {string_view()};
+            input.open(inputPath.string());
+
+            Measurement m {puzzle, scale, input.size(), countLines(input.text())};
+            double totalSeconds = 0.0;
+
+            for (unsigned run = 0;  run < numRuns && totalSeconds < timeout;  ++run) {
+                const auto result = runOnce(binDir / puzzle, inputPath, quiet, timeout);
+                m.peakRssKiB = max(m.peakRssKiB, result.peakRssKiB);
+                if (result.status != "ok") {
+                    m.status = result.status;
+                    break;
+                }
+                m.seconds.push_back(result.seconds);
+                totalSeconds += result.seconds;
+            }
+
+            printRow(m);
+            measurements.push_back(m);
+
+            if (m.status != "ok") {
+                anyFailed = anyFailed || (m.status != "timeout");
+                break;
+            }
+        }
+    }
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, measurements)) {
+        cerr << "Error: Unable to write \"" << jsonPath << "\".\n";
+        return 1;
+    }
+
+    return anyFailed ? 1 : 0;
+}
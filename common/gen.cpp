@@ -0,0 +1,131 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Puzzle Input Generator
+//
+// Writes generated, well-formed puzzle input for one of days 1 through 12 to standard output (see generator.h). The
+// same day, seed, size and parameters always give the same input.
+//
+// Usage: aocgen [--seed <n>] [--size <bytes>[k|M|G]] [--set <name>=<value>]... [--params] <day>
+//
+//     --seed <n>               Random seed (default 0).
+//     --size <bytes>[k|M|G]    Approximate input size, optionally in kibibytes, mebibytes or gibibytes (default 20k).
+//     --set <name>=<value>     Sets one of the day's distribution parameters.
+//     --params                 Lists the day's distribution parameters and their defaults, instead of generating input.
+//
+// For example, `aocgen --seed 7 --size 1G --set width=1000 11 > galaxies.txt`.
+//----------------------------------------------------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "generator.h"
+
+using namespace std;
+
+
+bool parseSize(const string& text, uint64_t& size) {
+    // Parses a byte count with an optional binary suffix. Returns false if the text is malformed.
+
+    char* end;
+    size = strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str())
+        return false;
+
+    const string_view suffix {end};
+    if (suffix == "k" || suffix == "K")
+        size <<= 10;
+    else if (suffix == "m" || suffix == "M")
+        size <<= 20;
+    else if (suffix == "g" || suffix == "G")
+        size <<= 30;
+    else if (!suffix.empty())
+        return false;
+
+    return size > 0;
+}
+
+
+int main(int argc, char* argv[]) {
+    aoc::GeneratorOptions options;
+    bool listParameters = false;
+    int day = 0;
+
+    for (int argi = 1; argi < argc; ++argi) {
+        const string_view arg {argv[argi]};
+        if (arg == "--params") {
+            listParameters = true;
+        } else if (arg == "--seed" || arg == "--size" || arg == "--set") {
+            if (++argi >= argc) {
+                cerr << "Error: Missing value for " << arg << " option.\n";
+                return 1;
+            }
+            const string value {argv[argi]};
+            bool good = true;
+
+            if (arg == "--seed") {
+                char* end;
+                options.seed = strtoull(value.c_str(), &end, 10);
+                good = (end != value.c_str() && *end == 0);
+            } else if (arg == "--size") {
+                good = parseSize(value, options.size);
+            } else {
+                const auto equals = value.find('=');
+                char* end = nullptr;
+                if (equals != string::npos)
+                    options.parameters[value.substr(0, equals)] = strtod(value.c_str() + equals + 1, &end);
+                good = (equals != string::npos && end != value.c_str() + equals + 1 && *end == 0);
+            }
+
+            if (!good) {
+                cerr << "Error: Bad value '" << value << "' for option '" << arg << "'.\n";
+                return 1;
+            }
+        } else if (arg.starts_with("-")) {
+            cerr << "Error: Unrecognized option \"" << arg << "\".\n";
+            return 1;
+        } else if (day == 0) {
+            day = atoi(argv[argi]);
+            if (aoc::generatorParameters(day).empty()) {
+                cerr << "Error: No generator for day \"" << arg << "\" (days 1 through 12 have generators).\n";
+                return 1;
+            }
+        } else {
+            cerr << "Error: Unexpected argument \"" << arg << "\".\n";
+            return 1;
+        }
+    }
+
+    if (day == 0) {
+        cerr << "usage: aocgen [--seed <n>] [--size <bytes>[k|M|G]] [--set <name>=<value>]... [--params] <day>\n";
+        return 1;
+    }
+
+    const auto parameters = aoc::generatorParameters(day);
+
+    if (listParameters) {
+        for (const auto& parameter : parameters) {
+            cout << left << setw(13) << parameter.name << right << setw(8) << parameter.value
+                 << "  " << parameter.description << '\n';
+        }
+        return 0;
+    }
+
+    for (const auto& [name, value] : options.parameters) {
+        bool known = false;
+        for (const auto& parameter : parameters)
+            known = known || (parameter.name == name);
+        if (!known) {
+            cerr << "Error: Day " << day << " has no parameter \"" << name << "\" (see --params).\n";
+            return 1;
+        }
+    }
+
+    if (!aoc::generateInput(day, options, cout)) {
+        cerr << "Error: Unable to write generated input.\n";
+        return 1;
+    }
+
+    return 0;
+}
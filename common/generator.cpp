@@ -0,0 +1,927 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Puzzle Input Generators
+//
+// See generator.h.
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "generator.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace aoc {
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+// Distribution parameters of each day's generator, with their defaults.
+
+const GeneratorParameter day01Parameters[] {
+    { "length",      30,     "Mean line length, in characters" },
+    { "digits",      0.1,    "Probability that a character is a digit" },
+    { "words",       0.05,   "Probability that a spelled-out digit precedes a character" },
+};
+
+const GeneratorParameter day02Parameters[] {
+    { "draws",       6,      "Greatest number of draws in a game" },
+    { "cubes",       20,     "Greatest number of cubes of one color in a draw" },
+};
+
+const GeneratorParameter day03Parameters[] {
+    { "width",       140,    "Schematic width, in characters" },
+    { "numbers",     0.08,   "Probability that a cell starts a part number" },
+    { "symbols",     0.03,   "Probability that a cell holds a symbol" },
+    { "gears",       0.3,    "Fraction of symbols that are gears (`*`)" },
+};
+
+const GeneratorParameter day04Parameters[] {
+    { "winning",     10,     "Count of winning numbers on each card" },
+    { "have",        25,     "Count of numbers you have on each card" },
+    { "max",         99,     "Greatest card number" },
+    { "matches",     0.7,    "Mean count of matching numbers per card (below 1 keeps part two's card count bounded)" },
+};
+
+const GeneratorParameter day05Parameters[] {
+    { "seeds",       10,     "Count of seed ranges (pairs of seed numbers)" },
+    { "seedlength",  1e6,    "Greatest length of a seed range" },
+    { "gaps",        0.1,    "Probability of an unmapped gap before each map range" },
+};
+
+const GeneratorParameter day06Parameters[] {
+    { "time",        100,    "Greatest race time" },
+};
+
+const GeneratorParameter day07Parameters[] {
+    { "kinds",       13,     "Count of distinct card labels used (fewer gives more pairs and sets)" },
+    { "bid",         1000,   "Greatest bid" },
+};
+
+const GeneratorParameter day08Parameters[] {
+    { "ghosts",      6,      "Count of starting nodes" },
+    { "multiple",    6,      "Greatest cycle length, as a multiple of the common base length" },
+    { "twins",       0.5,    "Probability that a step along a ghost's path has two nodes rather than one" },
+    { "steps",       263,    "Count of left/right instructions" },
+};
+
+const GeneratorParameter day09Parameters[] {
+    { "values",      21,     "Count of values in each sequence" },
+    { "degree",      8,      "Greatest degree of the polynomial behind each sequence" },
+    { "coefficient", 10,     "Greatest magnitude of each sequence's initial differences" },
+};
+
+const GeneratorParameter day10Parameters[] {
+    { "width",       140,    "Map width, in tiles" },
+    { "north",       0.5,    "Probability that a loop section branches north rather than west" },
+    { "prune",       0.5,    "Probability that a dead-end section is left out of the loop" },
+    { "junk",        0.7,    "Probability that a tile off the loop holds a junk pipe" },
+};
+
+const GeneratorParameter day11Parameters[] {
+    { "width",       140,    "Image width, in pixels" },
+    { "galaxies",    0.02,   "Probability that a pixel in a non-empty row and column is a galaxy" },
+    { "empty",       0.05,   "Probability that a row or column is empty" },
+};
+
+const GeneratorParameter day12Parameters[] {
+    { "length",      20,     "Greatest row length (rows are at least half this long)" },
+    { "damaged",     0.4,    "Probability that a spring is damaged" },
+    { "unknown",     0.5,    "Probability that a spring's condition is unknown (`?`)" },
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Random {
+    // xoshiro256** pseudo-random number generator. Defined here (rather than using <random> distributions, whose
+    // results vary by library) so that generated input is the same everywhere.
+
+  public:
+    explicit Random(uint64_t seed) {
+        for (auto& word : state) {
+            // Seed with splitmix64.
+            seed += 0x9e3779b97f4a7c15;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Returns a new generator whose sequence is independent of this one's.
+    Random split() { return Random(next()); }
+
+    // Returns a value in [0, n), or 0 if n is 0.
+    uint64_t below(uint64_t n) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * n) >> 64);
+    }
+
+    // Returns a value in [low, high].
+    int64_t between(int64_t low, int64_t high) {
+        return low + static_cast<int64_t>(below(static_cast<uint64_t>(high - low) + 1));
+    }
+
+    // Returns a value in [0, 1).
+    double uniform() {
+        return (next() >> 11) * 0x1.0p-53;
+    }
+
+    bool chance(double probability) {
+        return uniform() < probability;
+    }
+
+    template <typename T>
+    void shuffle(std::vector<T>& items, size_t count) {
+        // Moves a random selection of `count` items, in random order, to the front.
+        for (size_t i = 0;  i < count && i + 1 < items.size();  ++i)
+            std::swap(items[i], items[i + below(items.size() - i)]);
+    }
+
+  private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t state[4];
+};
+
+
+class Generator {
+    // Shared state of a generator run: parameters, random numbers, and buffered output.
+
+  public:
+    Generator(int day, const GeneratorOptions& options, std::span<const GeneratorParameter> parameters,
+              std::ostream& out)
+      : random(options.seed ^ (static_cast<uint64_t>(day) << 56)), options(options), parameters(parameters), out(out)
+    {
+    }
+
+    ~Generator() {
+        flush();
+    }
+
+    Random random;
+
+    double param(std::string_view name) const {
+        if (auto it = options.parameters.find(std::string(name));  it != options.parameters.end())
+            return it->second;
+        for (const auto& parameter : parameters) {
+            if (parameter.name == name)
+                return parameter.value;
+        }
+        return 0;
+    }
+
+    // Returns the parameter value rounded to an integer no less than `least`.
+    int64_t count(std::string_view name, int64_t least = 1) const {
+        return std::max<int64_t>(least, std::llround(param(name)));
+    }
+
+    uint64_t size()    const { return options.size; }
+    uint64_t written() const { return numWritten; }
+    bool     full()    const { return numWritten >= options.size; }
+
+    void put(char c) {
+        buffer += c;
+        ++numWritten;
+        if (buffer.size() >= (1 << 16))
+            flush();
+    }
+
+    void put(std::string_view text) {
+        buffer += text;
+        numWritten += text.size();
+        if (buffer.size() >= (1 << 16))
+            flush();
+    }
+
+    void putNumber(int64_t value, int width = 0) {
+        // Writes the value right-aligned in a field of the given width.
+        char digits[24];
+        const auto length = std::to_chars(digits, digits + sizeof(digits), value).ptr - digits;
+        for (auto i = length;  i < width;  ++i)
+            put(' ');
+        put(std::string_view(digits, length));
+    }
+
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+  private:
+    const GeneratorOptions&              options;
+    std::span<const GeneratorParameter>  parameters;
+    std::ostream&                        out;
+    std::string                          buffer;
+    uint64_t                             numWritten {0};
+};
+
+
+int numDigits(uint64_t value) {
+    int digits = 1;
+    for (;  value >= 10;  value /= 10)
+        ++digits;
+    return digits;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 1: Calibration lines of letters and digits, some with digits spelled out. Every line has at least one digit.
+
+void generateDay01(Generator& gen) {
+    static const std::string_view words[] {
+        "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"
+    };
+
+    auto& random = gen.random;
+    const int64_t length = gen.count("length");
+    const double  digits = gen.param("digits");
+    const double  spelled = gen.param("words");
+    std::string   line;
+
+    do {
+        line.clear();
+        bool hasDigit = false;
+
+        for (auto n = random.between(std::max<int64_t>(1, length / 2), length * 3 / 2);  n > 0;  --n) {
+            if (random.chance(spelled))
+                line += words[random.below(9)];
+            if (random.chance(digits)) {
+                line += static_cast<char>('1' + random.below(9));
+                hasDigit = true;
+            } else {
+                line += static_cast<char>('a' + random.below(26));
+            }
+        }
+
+        if (!hasDigit)
+            line.insert(random.below(line.size() + 1), 1, static_cast<char>('1' + random.below(9)));
+
+        gen.put(line);
+        gen.put('\n');
+    } while (!gen.full());
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 2: Game records, each a list of draws of red, green and blue cubes.
+
+void generateDay02(Generator& gen) {
+    static const std::string_view colors[] { "red", "green", "blue" };
+
+    auto& random = gen.random;
+    const int64_t draws = gen.count("draws");
+    const int64_t cubes = gen.count("cubes");
+    std::vector<int> order {0, 1, 2};
+
+    for (int64_t game = 1;  !gen.full();  ++game) {
+        gen.put("Game ");
+        gen.putNumber(game);
+        gen.put(':');
+
+        for (auto draw = random.between(1, draws);  draw > 0;  --draw) {
+            random.shuffle(order, order.size());
+            const auto numColors = random.between(1, 3);
+            for (int64_t i = 0;  i < numColors;  ++i) {
+                gen.put(i ? ", " : " ");
+                gen.putNumber(random.between(1, cubes));
+                gen.put(' ');
+                gen.put(colors[order[i]]);
+            }
+            if (draw > 1)
+                gen.put(';');
+        }
+
+        gen.put('\n');
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 3: An engine schematic of part numbers (one to three digits) and symbols on a field of dots.
+
+void generateDay03(Generator& gen) {
+    static const std::string_view symbols = "#+$/=%@&-";
+
+    auto& random = gen.random;
+    const int64_t width        = gen.count("width");
+    const double  numberChance = gen.param("numbers");
+    const double  symbolChance = gen.param("symbols");
+    const double  gearChance   = gen.param("gears");
+    std::string   row;
+
+    do {
+        row.assign(width, '.');
+
+        for (int64_t i = 0;  i < width;  ) {
+            const double r = random.uniform();
+            if (r < numberChance) {
+                // A number is always followed by a non-digit, so adjacent numbers don't run together.
+                const auto length = std::min(random.between(1, 3), width - i);
+                row[i++] = static_cast<char>('1' + random.below(9));
+                for (int64_t j = 1;  j < length;  ++j)
+                    row[i++] = static_cast<char>('0' + random.below(10));
+                ++i;
+            } else if (r < numberChance + symbolChance) {
+                row[i++] = random.chance(gearChance) ? '*' : symbols[random.below(symbols.size())];
+            } else {
+                ++i;
+            }
+        }
+
+        gen.put(row);
+        gen.put('\n');
+    } while (!gen.full());
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 4: Scratchcards. The number of matches on each card is binomially distributed with the given mean, and capped so
+// that no card wins copies of cards past the end of the table.
+
+void generateDay04(Generator& gen) {
+    auto& random = gen.random;
+    const int64_t winning  = gen.count("winning");
+    const int64_t have     = gen.count("have");
+    const int64_t maxValue = std::max(gen.count("max"), winning + have);
+    const double  matchChance = std::clamp(gen.param("matches") / have, 0.0, 1.0);
+    const int     valueWidth  = numDigits(maxValue) + 1;
+
+    // Size the table up front, to know where it ends.
+
+    int64_t idWidth  = 4;
+    int64_t numCards = 1;
+    for (int pass = 0;  pass < 2;  ++pass) {
+        const uint64_t lineSize = 4 + idWidth + 3 + (winning + have) * valueWidth;
+        numCards = std::max<int64_t>(1, gen.size() / lineSize);
+        idWidth  = std::max(4, numDigits(numCards) + 1);
+    }
+
+    std::vector<int64_t> values;
+    for (int64_t value = 1;  value <= maxValue;  ++value)
+        values.push_back(value);
+
+    std::vector<int64_t> numbersYouHave;
+
+    for (int64_t card = 1;  card <= numCards;  ++card) {
+        int64_t matches = 0;
+        for (int64_t i = 0;  i < have;  ++i)
+            matches += random.chance(matchChance);
+        matches = std::min({matches, winning, numCards - card});
+
+        // The first `winning` values are the winning numbers. You have the first `matches` of those, plus enough
+        // values from beyond them.
+
+        random.shuffle(values, winning + have - matches);
+
+        numbersYouHave.assign(values.begin(), values.begin() + matches);
+        numbersYouHave.insert(
+            numbersYouHave.end(), values.begin() + winning, values.begin() + winning + have - matches);
+        random.shuffle(numbersYouHave, numbersYouHave.size());
+
+        gen.put("Card");
+        gen.putNumber(card, idWidth);
+        gen.put(':');
+        for (int64_t i = 0;  i < winning;  ++i)
+            gen.putNumber(values[i], valueWidth);
+        gen.put(" |");
+        for (auto value : numbersYouHave)
+            gen.putNumber(value, valueWidth);
+        gen.put('\n');
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 5: An almanac of seed ranges and seven maps. Each map's source ranges are disjoint and ascending through the
+// 32-bit range (with occasional unmapped gaps), and are sized so that the whole almanac comes to the requested size.
+
+void generateDay05(Generator& gen) {
+    static const std::string_view categories[] {
+        "seed", "soil", "fertilizer", "water", "light", "temperature", "humidity", "location"
+    };
+    constexpr uint64_t limit = uint64_t(1) << 32;
+
+    auto& random = gen.random;
+    const int64_t  numSeeds   = gen.count("seeds");
+    const uint64_t seedLength = std::min<uint64_t>(limit, gen.count("seedlength"));
+    const double   gapChance  = gen.param("gaps");
+
+    gen.put("seeds:");
+    for (int64_t i = 0;  i < numSeeds;  ++i) {
+        const uint64_t length = random.between(1, seedLength);
+        gen.put(' ');
+        gen.putNumber(random.below(limit - length + 1));
+        gen.put(' ');
+        gen.putNumber(length);
+    }
+    gen.put('\n');
+
+    // Each map line holds two numbers of mostly ten digits, and a range length of about `span`.
+
+    const uint64_t available = gen.size() - std::min(gen.size(), gen.written());
+    uint64_t numRanges = std::max<uint64_t>(1, available / (7 * 33));
+    uint64_t span      = std::max<uint64_t>(1, limit / numRanges);   // Mean source range length
+    for (int pass = 0;  pass < 2;  ++pass) {
+        numRanges = std::max<uint64_t>(1, available / (7 * (23 + numDigits(span))));
+        span      = std::max<uint64_t>(1, limit / numRanges);
+    }
+
+    for (int map = 0;  map < 7;  ++map) {
+        gen.put('\n');
+        gen.put(categories[map]);
+        gen.put("-to-");
+        gen.put(categories[map + 1]);
+        gen.put(" map:\n");
+
+        uint64_t source = 0;
+        for (uint64_t range = 0;  range < numRanges && source < limit;  ++range) {
+            if (range > 0 && random.chance(gapChance))
+                source += random.below(std::min(span, limit - source));
+
+            const uint64_t length = std::min<uint64_t>(random.between(1, 2 * span - 1), limit - source);
+            gen.putNumber(random.below(limit - length + 1));
+            gen.put(' ');
+            gen.putNumber(source);
+            gen.put(' ');
+            gen.putNumber(length);
+            gen.put('\n');
+
+            source += length;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 6: A line of race times and a line of record distances. Every record can be beaten.
+
+void generateDay06(Generator& gen) {
+    const int64_t maxTime   = gen.count("time", 2);
+    const int     width     = numDigits(maxTime * maxTime / 4) + 3;
+    const int64_t numRaces  = std::max<uint64_t>(1, gen.size() / (2 * width));
+
+    // The distance line needs each race's time again, so replay the times from a copy of their generator.
+
+    Random times = gen.random.split();
+    Random timesAgain = times;
+    Random distances = gen.random.split();
+
+    gen.put("Time:    ");
+    for (int64_t race = 0;  race < numRaces;  ++race)
+        gen.putNumber(times.between((maxTime + 2) / 2, maxTime), width);
+
+    gen.put("\nDistance:");
+    for (int64_t race = 0;  race < numRaces;  ++race) {
+        const int64_t time = timesAgain.between((maxTime + 2) / 2, maxTime);
+        gen.putNumber(distances.below(time * time / 4), width);
+    }
+    gen.put('\n');
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 7: Camel Cards hands and bids.
+
+void generateDay07(Generator& gen) {
+    static const std::string_view labels = "AKQJT98765432";
+
+    auto& random = gen.random;
+    const int64_t kinds  = std::min<int64_t>(gen.count("kinds"), labels.size());
+    const int64_t maxBid = gen.count("bid");
+
+    do {
+        for (int card = 0;  card < 5;  ++card)
+            gen.put(labels[random.below(kinds)]);
+        gen.put(' ');
+        gen.putNumber(random.between(1, maxBid));
+        gen.put('\n');
+    } while (!gen.full());
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 8: Left/right instructions and a node network. Ghost i starts at a node ending in `A` (ghost 0 at AAA), and walks
+// a cycle of m(i) * base steps, for a random multiple m(i): each step along the cycle holds one or two nodes, and
+// whichever way a ghost turns, it moves on to the next step. The last step leads to the ghost's node ending in `Z` (ZZZ
+// for ghost 0), which leads back to the first step, as the start node does. So ghost i is at its end node exactly every
+// m(i) * base steps; part one takes m(0) * base steps, and part two takes base * lcm(m(0), m(1), ...). Node names are
+// scrambled with a random bijection, so nodes aren't listed in name order.
+
+void generateDay08(Generator& gen) {
+    static const std::string_view letters = "BCDEFGHIJKLMNOPQRSTUVWXY";   // Never ending a name in A or Z
+
+    auto& random = gen.random;
+    const int64_t numGhosts   = gen.count("ghosts");
+    const int64_t maxMultiple = gen.count("multiple");
+    const double  twinChance  = std::clamp(gen.param("twins"), 0.0, 1.0);
+    const int64_t numSteps    = gen.count("steps");
+
+    for (int64_t i = 0;  i < numSteps;  ++i)
+        gen.put(random.chance(0.5) ? 'L' : 'R');
+    gen.put("\n\n");
+
+    std::vector<uint64_t> multiples(numGhosts);
+    uint64_t multipleSum = 0;
+    for (auto& multiple : multiples) {
+        multiple = random.between(1, maxMultiple);
+        multipleSum += multiple;
+    }
+
+    // Choose the name width and path base length to fill the requested size.
+
+    const uint64_t available = gen.size() - std::min(gen.size(), gen.written());
+    int      nameWidth = 3;
+    uint64_t base;
+    uint64_t capacity;
+
+    while (true) {
+        const double lineSize = (3 * nameWidth + 8) * (1 + twinChance);
+        base = std::max<uint64_t>(2, static_cast<uint64_t>(available / lineSize / multipleSum));
+
+        capacity = 1;
+        for (int i = 0;  i < nameWidth;  ++i)
+            capacity *= letters.size();
+        if (capacity > 2 * base * multipleSum + numGhosts)
+            break;
+        ++nameWidth;
+    }
+
+    auto label = [&](uint64_t id) {
+        std::string result(nameWidth, letters[0]);
+        for (int i = nameWidth - 1;  i >= 0 && id > 0;  --i, id /= letters.size())
+            result[i] = letters[id % letters.size()];
+        return result;
+    };
+
+    // Node ids map to names through id * scale + offset, modulo the capacity. The capacity is a power of 24, so any
+    // scale that's odd and not a multiple of three makes this a bijection.
+
+    uint64_t scale = random.below(capacity) | 1;
+    if (scale % 3 == 0)
+        scale = (scale + 2) % capacity;
+    const uint64_t offset = random.below(capacity);
+
+    auto name = [&](uint64_t id) {
+        return label(static_cast<uint64_t>((static_cast<unsigned __int128>(id) * scale + offset) % capacity));
+    };
+
+    auto putNode = [&](const std::string& node, const std::string& left, const std::string& right) {
+        const bool swap = random.chance(0.5);
+        gen.put(node);
+        gen.put(" = (");
+        gen.put(swap ? right : left);
+        gen.put(", ");
+        gen.put(swap ? left : right);
+        gen.put(")\n");
+    };
+
+    auto stepSize = [&]() -> uint64_t { return random.chance(twinChance) ? 2 : 1; };
+
+    uint64_t nextId = 0;
+
+    for (int64_t ghost = 0;  ghost < numGhosts;  ++ghost) {
+        const std::string prefix     = label(ghost).substr(1);
+        const std::string startNode  = ghost ? prefix + 'A' : "AAA";
+        const std::string endNode    = ghost ? prefix + 'Z' : "ZZZ";
+        const uint64_t    pathLength = multiples[ghost] * base;
+
+        // Each step is a run of consecutive ids, the first and last of which are its successors' left and right.
+
+        const uint64_t firstId   = nextId;
+        const uint64_t firstSize = stepSize();
+        uint64_t       stepId    = firstId;
+        uint64_t       size      = firstSize;
+        nextId += size;
+
+        putNode(startNode, name(firstId), name(firstId + firstSize - 1));
+
+        for (uint64_t position = 1;  position < pathLength;  ++position) {
+            const bool     last     = (position + 1 == pathLength);
+            const uint64_t nextSize = last ? 0 : stepSize();
+            const std::string left  = last ? endNode : name(nextId);
+            const std::string right = last ? endNode : name(nextId + nextSize - 1);
+
+            for (uint64_t i = 0;  i < size;  ++i)
+                putNode(name(stepId + i), left, right);
+
+            stepId = nextId;
+            size   = nextSize;
+            nextId += nextSize;
+        }
+
+        putNode(endNode, name(firstId), name(firstId + firstSize - 1));
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 9: Sequences of polynomial values. Each sequence is built up from random initial differences, so that repeated
+// differencing is sure to reach all zeros.
+
+void generateDay09(Generator& gen) {
+    auto& random = gen.random;
+    const int64_t numValues   = gen.count("values", 2);
+    const int64_t maxDegree   = std::min(gen.count("degree", 0), numValues - 2);
+    const int64_t coefficient = gen.count("coefficient", 0);
+    std::vector<int64_t> differences;
+
+    do {
+        differences.resize(random.between(0, maxDegree) + 1);
+        for (auto& difference : differences)
+            difference = random.between(-coefficient, coefficient);
+
+        for (int64_t i = 0;  i < numValues;  ++i) {
+            if (i > 0)
+                gen.put(' ');
+            gen.putNumber(differences[0]);
+            for (size_t order = 0;  order + 1 < differences.size();  ++order)
+                differences[order] += differences[order + 1];
+        }
+        gen.put('\n');
+    } while (!gen.full());
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 10: A pipe map with a single loop among junk pipes. The map is divided into 3x3 blocks, each holding a ring of
+// pipe around a center tile, and the rings are joined along the branches of a random spanning tree of the blocks (each
+// block joined to its neighbor to the north or west -- the "binary tree" maze algorithm, which needs just one row of
+// look-ahead, plus one more to find the dead ends). Joining two rings across a pair of parallel pipe segments merges
+// them into one, so the tree leaves a single loop that passes through every ring tile and encloses every block's center
+// tile. Some dead-end blocks are then left out of the tree, and every tile off the loop (including the enclosed
+// centers) may hold a junk pipe, except next to the start tile, whose shape is deduced from its neighbors.
+
+void generateDay10(Generator& gen) {
+    enum : uint8_t { North = 1, East = 2, South = 4, West = 8 };
+    static const std::string_view junkPipes = "|-LJ7F";
+
+    auto& random = gen.random;
+    const int64_t blocksWide  = std::max<int64_t>(1, gen.count("width") / 3);
+    const int64_t blocksHigh  = std::max<uint64_t>(1, gen.size() / (3 * (3 * blocksWide + 1)));
+    const double  northChance = gen.param("north");
+    const double  pruneChance = gen.param("prune");
+    const double  junkChance  = gen.param("junk");
+
+    auto pipe = [](uint8_t connections) {
+        switch (connections) {
+            case North | South: return '|';
+            case East  | West:  return '-';
+            case North | East:  return 'L';
+            case North | West:  return 'J';
+            case South | West:  return '7';
+            case South | East:  return 'F';
+            default:            return '.';
+        }
+    };
+
+    // The start tile: a random ring tile of a random block.
+
+    static const int ringTiles[8][2] { {0,0}, {0,1}, {0,2}, {1,2}, {2,2}, {2,1}, {2,0}, {1,0} };
+    const int64_t startRow = random.below(blocksHigh);
+    const int64_t startCol = random.below(blocksWide);
+    const auto&   startTile = ringTiles[random.below(8)];
+    const int64_t startY    = 3 * startRow + startTile[0];
+    const int64_t startX    = 3 * startCol + startTile[1];
+
+    auto junk = [&](int64_t y, int64_t x) {
+        if (std::abs(y - startY) + std::abs(x - startX) == 1)
+            return '.';
+        return random.chance(junkChance) ? junkPipes[random.below(junkPipes.size())] : '.';
+    };
+
+    // Each block's link to its parent block (North, West, or none for the root).
+
+    std::vector<uint8_t> links(blocksWide), nextLinks(blocksWide), laterLinks(blocksWide);
+    auto chooseLinks = [&](int64_t row, std::vector<uint8_t>& rowLinks) {
+        for (int64_t col = 0;  col < blocksWide;  ++col) {
+            if (row == 0)
+                rowLinks[col] = (col == 0) ? 0 : West;
+            else if (col == 0)
+                rowLinks[col] = North;
+            else
+                rowLinks[col] = random.chance(northChance) ? North : West;
+        }
+    };
+
+    // Whether each block is left out of the loop. Only blocks that no other block links to (never the start block) are
+    // left out, so the rest of the tree stays connected.
+
+    std::vector<char> pruned(blocksWide), nextPruned(blocksWide);
+    auto choosePruned = [&](int64_t row, const std::vector<uint8_t>& rowLinks, const std::vector<uint8_t>& belowLinks,
+                            std::vector<char>& rowPruned) {
+        for (int64_t col = 0;  col < blocksWide;  ++col) {
+            const bool hasChild = (col + 1 < blocksWide && rowLinks[col + 1] == West)
+                               || (row + 1 < blocksHigh && belowLinks[col] == North);
+            const bool isStart  = (row == startRow && col == startCol);
+            rowPruned[col] = !hasChild && !isStart && random.chance(pruneChance);
+        }
+    };
+
+    chooseLinks(0, links);
+    if (blocksHigh > 1)
+        chooseLinks(1, nextLinks);
+    choosePruned(0, links, nextLinks, pruned);
+
+    std::string rows[3];
+
+    for (int64_t blockRow = 0;  blockRow < blocksHigh;  ++blockRow) {
+        if (blockRow + 2 < blocksHigh)
+            chooseLinks(blockRow + 2, laterLinks);
+        if (blockRow + 1 < blocksHigh)
+            choosePruned(blockRow + 1, nextLinks, laterLinks, nextPruned);
+
+        for (auto& row : rows)
+            row.assign(3 * blocksWide, '.');
+
+        for (int64_t col = 0;  col < blocksWide;  ++col) {
+            if (pruned[col]) {
+                for (int y = 0;  y < 3;  ++y) {
+                    for (int x = 0;  x < 3;  ++x)
+                        rows[y][3 * col + x] = junk(3 * blockRow + y, 3 * col + x);
+                }
+                continue;
+            }
+
+            uint8_t tiles[3][3] {
+                { East  | South, East | West, South | West },
+                { North | South, 0,           North | South },
+                { North | East,  East | West, North | West },
+            };
+
+            // Each join replaces the segment between two tiles of this ring with links to the neighboring ring.
+
+            const bool joinWest  = (links[col] == West);
+            const bool joinNorth = (links[col] == North);
+            const bool joinEast  = (col + 1 < blocksWide) && (links[col + 1] == West) && !pruned[col + 1];
+            const bool joinSouth = (blockRow + 1 < blocksHigh) && (nextLinks[col] == North) && !nextPruned[col];
+
+            if (joinWest)  { tiles[0][0] ^= South | West;  tiles[1][0] ^= North | West;  }
+            if (joinNorth) { tiles[0][0] ^= East  | North; tiles[0][1] ^= West  | North; }
+            if (joinEast)  { tiles[0][2] ^= South | East;  tiles[1][2] ^= North | East;  }
+            if (joinSouth) { tiles[2][0] ^= East  | South; tiles[2][1] ^= West  | South; }
+
+            for (int y = 0;  y < 3;  ++y) {
+                for (int x = 0;  x < 3;  ++x)
+                    rows[y][3 * col + x] = pipe(tiles[y][x]);
+            }
+
+            rows[1][3 * col + 1] = junk(3 * blockRow + 1, 3 * col + 1);
+
+            if (blockRow == startRow && col == startCol)
+                rows[startTile[0]][3 * col + startTile[1]] = 'S';
+        }
+
+        for (const auto& row : rows) {
+            gen.put(row);
+            gen.put('\n');
+        }
+
+        std::swap(links, nextLinks);
+        std::swap(nextLinks, laterLinks);
+        std::swap(pruned, nextPruned);
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 11: An image of galaxies, with some rows and columns left empty.
+
+void generateDay11(Generator& gen) {
+    auto& random = gen.random;
+    const int64_t width        = gen.count("width");
+    const double  galaxyChance = gen.param("galaxies");
+    const double  emptyChance  = gen.param("empty");
+
+    std::vector<bool> emptyColumns(width);
+    for (int64_t col = 0;  col < width;  ++col)
+        emptyColumns[col] = random.chance(emptyChance);
+
+    std::string row;
+
+    do {
+        row.assign(width, '.');
+        if (!random.chance(emptyChance)) {
+            for (int64_t col = 0;  col < width;  ++col) {
+                if (!emptyColumns[col] && random.chance(galaxyChance))
+                    row[col] = '#';
+            }
+        }
+        gen.put(row);
+        gen.put('\n');
+    } while (!gen.full());
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Day 12: Rows of spring conditions with their damaged group sizes. Each row is generated in full and then partly
+// hidden, so it always has at least one arrangement.
+
+void generateDay12(Generator& gen) {
+    auto& random = gen.random;
+    const int64_t maxLength     = gen.count("length");
+    const double  damagedChance = gen.param("damaged");
+    const double  unknownChance = gen.param("unknown");
+    std::string   springs;
+    std::vector<int64_t> groups;
+
+    do {
+        springs.resize(random.between((maxLength + 1) / 2, maxLength));
+        for (auto& spring : springs)
+            spring = random.chance(damagedChance) ? '#' : '.';
+        if (springs.find('#') == std::string::npos)
+            springs[random.below(springs.size())] = '#';
+
+        groups.clear();
+        for (size_t i = 0;  i < springs.size();  ++i) {
+            if (springs[i] != '#')
+                continue;
+            if (i == 0 || springs[i - 1] != '#')
+                groups.push_back(0);
+            ++groups.back();
+        }
+
+        for (auto& spring : springs) {
+            if (random.chance(unknownChance))
+                spring = '?';
+        }
+
+        gen.put(springs);
+        for (size_t i = 0;  i < groups.size();  ++i) {
+            gen.put(i ? ',' : ' ');
+            gen.putNumber(groups[i]);
+        }
+        gen.put('\n');
+    } while (!gen.full());
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct DayGenerator {
+    std::span<const GeneratorParameter> parameters;
+    void (*generate)(Generator&);
+};
+
+const DayGenerator dayGenerators[] {
+    { day01Parameters, generateDay01 },
+    { day02Parameters, generateDay02 },
+    { day03Parameters, generateDay03 },
+    { day04Parameters, generateDay04 },
+    { day05Parameters, generateDay05 },
+    { day06Parameters, generateDay06 },
+    { day07Parameters, generateDay07 },
+    { day08Parameters, generateDay08 },
+    { day09Parameters, generateDay09 },
+    { day10Parameters, generateDay10 },
+    { day11Parameters, generateDay11 },
+    { day12Parameters, generateDay12 },
+};
+
+}  // namespace
+
+
+std::span<const GeneratorParameter> generatorParameters(int day) {
+    if (day < 1 || day > static_cast<int>(std::size(dayGenerators)))
+        return {};
+    return dayGenerators[day - 1].parameters;
+}
+
+
+bool generateInput(int day, const GeneratorOptions& options, std::ostream& out) {
+    const auto parameters = generatorParameters(day);
+    if (parameters.empty())
+        return false;
+
+    for (const auto& [name, value] : options.parameters) {
+        auto matches = [&](const GeneratorParameter& parameter) { return parameter.name == name; };
+        if (std::none_of(parameters.begin(), parameters.end(), matches))
+            return false;
+    }
+
+    {
+        Generator gen(day, options, parameters, out);
+        dayGenerators[day - 1].generate(gen);
+    }
+
+    return static_cast<bool>(out);
+}
+
+}  // namespace aoc
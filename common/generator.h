@@ -0,0 +1,60 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Puzzle Input Generators
+//
+// Writes well-formed puzzle input of any size for days 1 through 12, for benchmarks and scaling tests. Output is fully
+// determined by the day, the seed, the size and the distribution parameters (the random number generator is our own,
+// so it's the same on every platform), and is written in a single streaming pass, so gigabyte-scale inputs need no
+// more memory than a line or two (or, for day 5, one map).
+//
+// Each day has its own distribution parameters, such as line lengths, number ranges and densities, listed (with their
+// defaults) by `generatorParameters()`. Generated inputs keep the properties the puzzles rely on: every day 8 ghost
+// reaches its end node, day 10 has exactly one loop through the start tile, and scratchcards never win copies of cards
+// past the end of the table, for example.
+//
+// Typical use:
+//
+//     aoc::GeneratorOptions options;
+//     options.seed = 42;
+//     options.size = 1 << 30;
+//     options.parameters["width"] = 1000;
+//     if (!aoc::generateInput(11, options, cout))
+//         ... no generator, or an unknown parameter ...
+//----------------------------------------------------------------------------------------------------------------------
+
+#ifndef AOC_GENERATOR_H
+#define AOC_GENERATOR_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <span>
+#include <string>
+
+
+namespace aoc {
+
+struct GeneratorParameter {
+    const char* name;
+    double      value;          // Default value
+    const char* description;
+};
+
+
+struct GeneratorOptions {
+    uint64_t                      seed {0};
+    uint64_t                      size {20'000};   // Approximate size of the generated input, in bytes
+    std::map<std::string, double> parameters;      // Overrides of the day's default parameter values
+};
+
+
+// Returns the distribution parameters of the given day's generator, with their default values. The span is empty if
+// there's no generator for that day.
+std::span<const GeneratorParameter> generatorParameters(int day);
+
+// Writes generated input for the given day to the given stream. Returns false if there's no generator for that day, or
+// if the options name a parameter that the day's generator doesn't have.
+bool generateInput(int day, const GeneratorOptions& options, std::ostream& out);
+
+}  // namespace aoc
+
+#endif  // AOC_GENERATOR_H
@@ -0,0 +1,235 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Shared Puzzle Input
+//
+// See input.h.
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "input.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace aoc {
+
+namespace {
+    // Runner-supplied input for the current thread, if any.
+    thread_local bool             hasThreadInput {false};
+    thread_local std::string_view threadInputText;
+}
+
+
+LineIterator::LineIterator(const char* begin, const char* end)
+  : next(begin), end(end)
+{
+    advance();
+}
+
+
+LineIterator& LineIterator::operator++() {
+    advance();
+    return *this;
+}
+
+
+void LineIterator::advance() {
+    // Moves to the line starting at `next`, or to the end iterator if there are no more lines.
+
+    if (!next || next >= end) {
+        next = nullptr;
+        line = {};
+        return;
+    }
+
+    auto newline = static_cast<const char*>(std::memchr(next, '\n', end - next));
+    const char* lineEnd = newline ? newline : end;
+
+    line = std::string_view(next, lineEnd - next);
+    next = newline ? newline + 1 : end;
+}
+
+
+Input::Input() {
+    if (hasThreadInput) {
+        bytes = threadInputText.data();
+        count = threadInputText.size();
+        return;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat info;
+    if (fstat(STDIN_FILENO, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+        if (mapping != MAP_FAILED) {
+            bytes = static_cast<const char*>(mapping);
+            count = info.st_size;
+            mapped = true;
+            return;
+        }
+    }
+
+    char chunk[1 << 16];
+    ssize_t numRead;
+    while ((numRead = read(STDIN_FILENO, chunk, sizeof(chunk))) > 0)
+        owned.insert(owned.end(), chunk, chunk + numRead);
+#else
+    char chunk[1 << 16];
+    while (std::cin.read(chunk, sizeof(chunk)) || std::cin.gcount() > 0)
+        owned.insert(owned.end(), chunk, chunk + std::cin.gcount());
+#endif
+
+    bytes = owned.data();
+    count = owned.size();
+}
+
+
+Input::Input(std::string_view text)
+  : bytes(text.data()), count(text.size())
+{
+}
+
+
+Input::~Input() {
+    release();
+}
+
+
+Input::Input(Input&& other) noexcept {
+    *this = std::move(other);
+}
+
+
+Input& Input::operator=(Input&& other) noexcept {
+    if (this == &other)
+        return *this;
+
+    release();
+
+    // Moving a vector keeps its buffer, so views into owned input remain valid.
+    owned    = std::move(other.owned);
+    bytes    = std::exchange(other.bytes, nullptr);
+    count    = std::exchange(other.count, 0);
+    position = std::exchange(other.position, 0);
+    mapped   = std::exchange(other.mapped, false);
+    other.owned.clear();
+
+    return *this;
+}
+
+
+bool Input::open(const std::string& path) {
+    release();
+
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            close(fd);
+            bytes = static_cast<const char*>(mapping);
+            count = info.st_size;
+            mapped = true;
+            return true;
+        }
+    }
+    close(fd);
+#endif
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    owned.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    bytes = owned.data();
+    count = owned.size();
+    return true;
+}
+
+
+bool Input::getline(std::string_view& line) {
+    if (position >= count) {
+        line = {};
+        return false;
+    }
+
+    const char* start = bytes + position;
+    auto newline = static_cast<const char*>(std::memchr(start, '\n', count - position));
+    const size_t length = newline ? newline - start : count - position;
+
+    line = std::string_view(start, length);
+    position += newline ? length + 1 : length;
+    return true;
+}
+
+
+bool Input::scanBlocks(size_t blockSize, const std::function<bool(std::string_view block)>& consume) {
+    bool mappable = hasThreadInput;
+
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat info;
+    if (fstat(STDIN_FILENO, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        mappable = true;
+#endif
+
+    if (mappable) {
+        const Input input;
+        return consume(input.text());
+    }
+
+    std::vector<char> block(blockSize);
+
+#if defined(__unix__) || defined(__APPLE__)
+    ssize_t numRead;
+    while ((numRead = read(STDIN_FILENO, block.data(), block.size())) > 0) {
+        if (!consume(std::string_view(block.data(), numRead)))
+            return false;
+    }
+#else
+    while (std::cin.read(block.data(), block.size()) || std::cin.gcount() > 0) {
+        if (!consume(std::string_view(block.data(), std::cin.gcount())))
+            return false;
+    }
+#endif
+
+    return true;
+}
+
+
+void Input::setThreadInput(std::string_view text) {
+    hasThreadInput = true;
+    threadInputText = text;
+}
+
+
+void Input::clearThreadInput() {
+    hasThreadInput = false;
+    threadInputText = {};
+}
+
+
+void Input::release() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (mapped)
+        munmap(const_cast<char*>(bytes), count);
+#endif
+
+    bytes    = nullptr;
+    count    = 0;
+    position = 0;
+    mapped   = false;
+    owned.clear();
+}
+
+}  // namespace aoc
@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Shared Puzzle Input
+//
+// Presents the puzzle input as one contiguous, read-only block of memory, with zero-copy line iteration through
+// `std::string_view`. When standard input is a regular file, it's mapped directly into memory; otherwise (a pipe, for
+// example) it's read into a single owned buffer. Within the `aoc` runner, the runner supplies each puzzle's input
+// (already loaded) for the thread running that puzzle.
+//
+// Typical use:
+//
+//     aoc::Input input;
+//     string_view line;
+//     while (input.getline(line)) {
+//         ...
+//     }
+//
+// or `for (string_view line : input.lines())`. Lines are views into the input, so they remain valid for the lifetime
+// of the `Input` object.
+//
+// Solvers that can consume their input incrementally can use `Input::scanBlocks()` instead, which avoids holding all
+// of a piped standard input in memory.
+//----------------------------------------------------------------------------------------------------------------------
+
+#ifndef AOC_INPUT_H
+#define AOC_INPUT_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace aoc {
+
+class LineIterator {
+    // Forward iterator over the newline-terminated lines of a block of text. The final line need not end with a
+    // newline. As with std::getline(), a trailing newline does not begin an additional empty line.
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::string_view;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const std::string_view*;
+    using reference         = const std::string_view&;
+
+    LineIterator() = default;
+    LineIterator(const char* begin, const char* end);
+
+    reference operator*()  const { return line; }
+    pointer   operator->() const { return &line; }
+
+    LineIterator& operator++();
+    LineIterator  operator++(int) { LineIterator prior = *this; ++*this; return prior; }
+
+    bool operator==(const LineIterator& other) const { return next == other.next && line.data() == other.line.data(); }
+
+  private:
+    void advance();
+
+    const char*      next {nullptr};   // Start of the line after the current one, or null at the end
+    const char*      end  {nullptr};
+    std::string_view line;
+};
+
+
+class LineRange {
+    // The lines of a block of text, for use in range-based for loops.
+
+  public:
+    LineRange(std::string_view text) : text(text) {}
+
+    LineIterator begin() const { return LineIterator(text.data(), text.data() + text.size()); }
+    LineIterator end()   const { return LineIterator(); }
+
+  private:
+    std::string_view text;
+};
+
+
+class Input {
+  public:
+    // Loads the puzzle input: the runner-supplied input for this thread if there is one, else all of standard input.
+    Input();
+
+    // Borrows the given text, which must outlive this object.
+    explicit Input(std::string_view text);
+
+    ~Input();
+
+    Input(Input&& other) noexcept;
+    Input& operator=(Input&& other) noexcept;
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+
+    // Replaces the contents with the given file, mapped into memory where possible. Returns false if the file could
+    // not be read, leaving the input empty.
+    bool open(const std::string& path);
+
+    const char*      data() const { return bytes; }
+    size_t           size() const { return count; }
+    std::string_view text() const { return {bytes, count}; }
+
+    // Reads the next line (without its newline) into `line`, like std::getline(). Returns false, with an empty line,
+    // once all input has been consumed.
+    bool getline(std::string_view& line);
+
+    // Returns all lines of the input, independent of the getline() position.
+    LineRange lines() const { return LineRange(text()); }
+
+    // Passes the puzzle input, in order, to `consume`. Input that can be mapped (a regular file on standard input) or
+    // that is supplied by the runner is passed as a single block. Otherwise standard input is read and passed in
+    // blocks of up to `blockSize` bytes, so its size is limited by the source rather than by memory. Stops and returns
+    // false as soon as `consume` does.
+    static bool scanBlocks(size_t blockSize, const std::function<bool(std::string_view block)>& consume);
+
+    // Sets or clears the input text supplied to Input objects constructed on the calling thread, in place of standard
+    // input. Used by the `aoc` runner.
+    static void setThreadInput(std::string_view text);
+    static void clearThreadInput();
+
+  private:
+    void release();
+
+    const char*       bytes    {nullptr};
+    size_t            count    {0};
+    size_t            position {0};     // Offset of the next line returned by getline()
+    bool              mapped   {false};
+    std::vector<char> owned;
+};
+
+}  // namespace aoc
+
+#endif  // AOC_INPUT_H
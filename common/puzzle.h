@@ -0,0 +1,73 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Shared Puzzle Plumbing
+//
+// Each puzzle solver lives in its own `puzzleNNx` namespace and is written as
+//
+//     int solve(int argc, char* argv[])
+//
+// followed (outside the namespace) by `AOC_PUZZLE_MAIN(NNx)`. Built on its own, that supplies the usual `main()`. Built
+// into the `aoc` runner (with AOC_RUNNER defined), it instead registers the solver by name, and `AOC_PUZZLE_STREAMS`
+// (placed at the top of the puzzle namespace) rebinds the solver's `cout` to a per-thread stream that the runner
+// attaches to a captured output buffer. Puzzle input is read through `aoc::Input` (see input.h), which the runner
+// supplies per thread as well.
+//----------------------------------------------------------------------------------------------------------------------
+
+#ifndef AOC_PUZZLE_H
+#define AOC_PUZZLE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace aoc {
+
+using Solver = int (*)(int argc, char* argv[]);
+
+struct Puzzle {
+    std::string name;   // Puzzle name, such as "07a"
+    Solver      solve;
+};
+
+
+inline std::vector<Puzzle>& puzzles() {
+    // Registered puzzle solvers, in registration order. The runner sorts these by name before use.
+    static std::vector<Puzzle> registry;
+    return registry;
+}
+
+
+struct PuzzleRegistration {
+    PuzzleRegistration(const char* name, Solver solve) {
+        puzzles().push_back({name, solve});
+    }
+};
+
+
+inline std::ostream& threadOutput() {
+    // The output stream for the puzzle running on the current thread. The runner sets its stream buffer.
+    thread_local std::ostream stream {nullptr};
+    return stream;
+}
+
+}  // namespace aoc
+
+
+#if defined(AOC_RUNNER)
+
+    #define AOC_PUZZLE_STREAMS \
+        thread_local std::ostream& cout = aoc::threadOutput();
+
+    #define AOC_PUZZLE_MAIN(name) \
+        static aoc::PuzzleRegistration puzzleRegistration##name {#name, puzzle##name::solve};
+
+#else
+
+    #define AOC_PUZZLE_STREAMS
+
+    #define AOC_PUZZLE_MAIN(name) \
+        int main(int argc, char* argv[]) { return puzzle##name::solve(argc, argv); }
+
+#endif
+
+#endif  // AOC_PUZZLE_H
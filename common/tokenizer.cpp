@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Shared Integer Tokenizer
+//
+// See tokenizer.h.
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "tokenizer.h"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace aoc {
+
+namespace {
+
+inline bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+
+#if defined(__SSE2__)
+
+inline unsigned digitMask(const char* p) {
+    // Returns a 16-bit mask with bit i set if p[i] is a decimal digit.
+
+    const __m128i chunk  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i offset = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+    const __m128i digits = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(9)), offset);
+    return static_cast<unsigned>(_mm_movemask_epi8(digits));
+}
+
+#endif
+
+
+size_t findDigit(const char* text, size_t i, size_t size) {
+    // Returns the offset of the first digit at or after i, or size if there are none.
+
+#if defined(__SSE2__)
+    for (;  i + 16 <= size;  i += 16) {
+        if (const unsigned mask = digitMask(text + i))
+            return i + std::countr_zero(mask);
+    }
+#endif
+
+    while (i < size && !isDigit(text[i]))
+        ++i;
+    return i;
+}
+
+
+size_t findNonDigit(const char* text, size_t i, size_t size) {
+    // Returns the offset of the first non-digit at or after i, or size if there are none.
+
+#if defined(__SSE2__)
+    for (;  i + 16 <= size;  i += 16) {
+        if (const unsigned mask = ~digitMask(text + i) & 0xffff)
+            return i + std::countr_zero(mask);
+    }
+#endif
+
+    while (i < size && isDigit(text[i]))
+        ++i;
+    return i;
+}
+
+
+uint64_t parseEightDigits(const char* digits, size_t length) {
+    // Converts a run of at most eight digits. The digits are right-aligned in a word padded with leading '0'
+    // characters, and then combined pairwise in three multiply-and-shift steps (1, 2, then 4 digits per lane).
+
+    if constexpr (std::endian::native == std::endian::little) {
+        char buffer[8];
+        std::memset(buffer, '0', 8);
+        std::memcpy(buffer + 8 - length, digits, length);
+
+        uint64_t word;
+        std::memcpy(&word, buffer, 8);
+
+        word -= 0x3030303030303030;
+        word = (word * 10) + (word >> 8);
+        word = (((word & 0x000000ff000000ff) * (100 + (1000000ull << 32)))
+             + (((word >> 16) & 0x000000ff000000ff) * (1 + (10000ull << 32)))) >> 32;
+        return word;
+    } else {
+        uint64_t value = 0;
+        for (size_t i = 0;  i < length;  ++i)
+            value = 10*value + (digits[i] - '0');
+        return value;
+    }
+}
+
+
+bool parseDigits(const char* digits, size_t length, uint64_t& value) {
+    // Converts a run of digits. Returns false if the value doesn't fit in 64 bits.
+
+    if (length <= 8) {
+        value = parseEightDigits(digits, length);
+        return true;
+    }
+
+    if (length <= 16) {
+        value = parseEightDigits(digits, length - 8) * 100'000'000 + parseEightDigits(digits + length - 8, 8);
+        return true;
+    }
+
+    // Long runs (rare, and possibly padded with leading zeros) are converted a digit at a time.
+
+    value = 0;
+    for (size_t i = 0;  i < length;  ++i) {
+        if (__builtin_mul_overflow(value, 10u, &value) || __builtin_add_overflow(value, digits[i] - '0', &value))
+            return false;
+    }
+    return true;
+}
+
+
+template <typename T>
+bool extract(std::string_view text, std::span<T> values, size_t& count, std::span<uint32_t> ends) {
+    constexpr bool isSigned = (T(-1) < T(0));
+
+    const char*  data = text.data();
+    const size_t size = text.size();
+
+    count = 0;
+
+    for (size_t i = 0;  count < values.size();  ) {
+        const size_t start = findDigit(data, i, size);
+        if (start >= size)
+            break;
+        const size_t end = findNonDigit(data, start, size);
+
+        uint64_t magnitude;
+        if (!parseDigits(data + start, end - start, magnitude))
+            return false;
+
+        if constexpr (isSigned) {
+            const bool negative = start > 0 && data[start - 1] == '-';
+            if (magnitude > uint64_t(INT64_MAX) + (negative ? 1 : 0))
+                return false;
+            values[count] = negative ? T(0 - magnitude) : T(magnitude);
+        } else {
+            values[count] = magnitude;
+        }
+
+        if (count < ends.size())
+            ends[count] = static_cast<uint32_t>(end);
+
+        ++count;
+        i = end;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+
+bool extractIntegers(std::string_view text, std::span<int64_t> values, size_t& count, std::span<uint32_t> ends) {
+    return extract(text, values, count, ends);
+}
+
+
+bool extractUnsigned(std::string_view text, std::span<uint64_t> values, size_t& count, std::span<uint32_t> ends) {
+    return extract(text, values, count, ends);
+}
+
+}  // namespace aoc
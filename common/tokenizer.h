@@ -0,0 +1,46 @@
+//----------------------------------------------------------------------------------------------------------------------
+// 2023 Advent of Code -- Shared Integer Tokenizer
+//
+// Extracts all of the integers from a line or a whole buffer of text, in order, into a caller-provided span. Anything
+// that isn't a digit separates integers. Digit runs are located sixteen bytes at a time with SSE2 (where available),
+// and converted eight digits at a time with SWAR arithmetic on 64-bit words.
+//
+// Typical use:
+//
+//     int64_t values[8];
+//     size_t  count;
+//     if (!aoc::extractIntegers(line, values, count))
+//         ... overflow ...
+//     for (size_t i = 0;  i < count;  ++i)
+//         ... values[i] ...
+//
+// Extraction stops early once the span is full; `aoc::maxIntegers(text)` gives a span size that's always sufficient.
+//----------------------------------------------------------------------------------------------------------------------
+
+#ifndef AOC_TOKENIZER_H
+#define AOC_TOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+
+namespace aoc {
+
+// Extracts signed integers. A minus sign immediately before a run of digits makes it negative. Sets `count` to the
+// number of integers extracted. If `ends` is non-empty, `ends[i]` receives the offset just past integer i (for as many
+// as fit). Returns false if an integer doesn't fit in 64 bits, in which case `count` covers the integers before it.
+bool extractIntegers(std::string_view text, std::span<int64_t> values, size_t& count, std::span<uint32_t> ends = {});
+
+// Extracts unsigned integers, as above. Minus signs are treated as separators.
+bool extractUnsigned(std::string_view text, std::span<uint64_t> values, size_t& count, std::span<uint32_t> ends = {});
+
+// Returns the greatest number of integers that the given text could hold.
+inline size_t maxIntegers(std::string_view text) {
+    return (text.size() + 1) / 2;
+}
+
+}  // namespace aoc
+
+#endif  // AOC_TOKENIZER_H